@@ -382,6 +382,10 @@ AppClient::AppClient(boost::asio::io_context& io, int& result) :
     ::cc_mqtt5_client_set_error_log_callback(m_client.get(), &AppClient::logMessageCb, this);
     ::cc_mqtt5_client_set_next_tick_program_callback(m_client.get(), &AppClient::nextTickProgramCb, this);
     ::cc_mqtt5_client_set_cancel_next_tick_wait_callback(m_client.get(), &AppClient::cancelNextTickWaitCb, this);
+
+    // The incomplete packets are kept by the library, all the reported data is consumed
+    [[maybe_unused]] auto ec = ::cc_mqtt5_client_set_incremental_recv_enabled(m_client.get(), true);
+    assert(ec == CC_Mqtt5ErrorCode_Success);
 }
 
 bool AppClient::sendConnect(CC_Mqtt5ConnectHandle connect)
@@ -11,7 +11,6 @@
 
 #include <array>
 #include <cstdint>
-#include <vector>
 
 namespace cc_mqtt5_client_app
 {
@@ -29,7 +28,6 @@ protected:
 private:
     using Socket = boost::asio::ip::tcp::socket;
     using InDataBuf = std::array<std::uint8_t, 4096>;
-    using DataBuf = std::vector<std::uint8_t>;
 
     TcpSession(boost::asio::io_context& io, const ProgramOptions& opts) :
         Base(io, opts),
@@ -41,7 +39,6 @@ private:
 
     Socket m_socket;
     InDataBuf m_inData;
-    DataBuf m_buf;
 };
 
 } // namespace cc_mqtt5_client_app
@@ -100,32 +100,10 @@ void TlsSession::doRead()
                 return;
             }
 
-            auto buf = &m_inData[0];
-            auto bufLen = bytesCount;
-            if (!m_buf.empty()) {
-                m_buf.reserve(m_buf.size() + bytesCount);
-                m_buf.insert(m_buf.end(), m_inData.begin(), m_inData.begin() + bytesCount);
-                buf = &m_buf[0];
-                bufLen = m_buf.size();
-            }
-
-            auto consumed = reportData(buf, bufLen);
-            do {
-                if (bufLen <= consumed) {
-                    m_buf.clear();
-                    break;
-                }
-
-                if (!m_buf.empty()) {
-                    assert(buf == &m_buf[0]);
-                    m_buf.erase(m_buf.begin(), m_buf.begin() + consumed);
-                    break;
-                }
-
-                assert(buf == &m_inData[0]);
-                m_buf.reserve(m_buf.size() + (bytesCount - consumed));
-                m_buf.insert(m_buf.end(), m_inData.begin() + consumed, m_inData.begin() + bytesCount);
-            } while (false);
+            // The incomplete trailing packet is stored by the client library
+            // (incremental receive mode), all the reported data is consumed.
+            [[maybe_unused]] auto consumed = reportData(&m_inData[0], bytesCount);
+            assert(consumed == bytesCount);
 
             doRead();
         }
@@ -15,7 +15,6 @@
 
 #include <array>
 #include <cstdint>
-#include <vector>
 
 namespace cc_mqtt5_client_app
 {
@@ -34,7 +33,6 @@ private:
     using SslContext = boost::asio::ssl::context;
     using Socket = boost::asio::ssl::stream<boost::asio::ip::tcp::socket>;
     using InDataBuf = std::array<std::uint8_t, 4096>;
-    using DataBuf = std::vector<std::uint8_t>;
 
     TlsSession(boost::asio::io_context& io, const ProgramOptions& opts);
     void doRead();
@@ -46,7 +44,6 @@ private:
     std::unique_ptr<SslContext> m_ctx;
     std::unique_ptr<Socket> m_socket;
     InDataBuf m_inData;
-    DataBuf m_buf;
 };
 
 } // namespace cc_mqtt5_client_app
@@ -263,6 +263,15 @@ struct CC_Mqtt5Publish;
 /// @ingroup publish
 typedef struct CC_Mqtt5Publish* CC_Mqtt5PublishHandle;
 
+/// @brief Declaration of the hidden structure used to define @ref CC_Mqtt5PublishTemplateHandle
+/// @ingroup publish
+struct CC_Mqtt5PublishTemplate;
+
+/// @brief Handle for reusable "publish" template.
+/// @details Returned by cc_mqtt5_client_publish_template_alloc() function.
+/// @ingroup publish
+typedef struct CC_Mqtt5PublishTemplate* CC_Mqtt5PublishTemplateHandle;
+
 /// @brief Declaration of the hidden structure used to define @ref CC_Mqtt5ReauthHandle
 /// @ingroup reauth
 struct CC_Mqtt5Reauth;
@@ -272,6 +281,16 @@ struct CC_Mqtt5Reauth;
 /// @ingroup reauth
 typedef struct CC_Mqtt5Reauth* CC_Mqtt5ReauthHandle;
 
+/// @brief Declaration of the hidden structure used to define @ref CC_Mqtt5LazyUserPropsHandle
+/// @ingroup global
+struct CC_Mqtt5LazyUserProps;
+
+/// @brief Handle of the "User Properties" of the received message, which haven't been decoded yet.
+/// @details Reported via @ref CC_Mqtt5MessageInfo and @ref CC_Mqtt5PublishResponse when the lazy decoding
+///     is enabled, see cc_mqtt5_client_set_lazy_props_enabled() and cc_mqtt5_client_fetch_user_props().
+/// @ingroup global
+typedef struct CC_Mqtt5LazyUserProps* CC_Mqtt5LazyUserPropsHandle;
+
 /// @brief Wraping structre of the single "User Property".
 /// @see @b cc_mqtt5_client_init_user_prop()
 /// @ingroup global
@@ -281,6 +300,15 @@ typedef struct
     const char* m_value; ///< Value string, can be NULL
 } CC_Mqtt5UserProp;
 
+/// @brief Single segment of the data buffer.
+/// @see @b cc_mqtt5_client_process_data_v()
+/// @ingroup client
+typedef struct
+{
+    const unsigned char* m_data; ///< Pointer to the segment data, can be NULL when m_dataLen is 0.
+    unsigned m_dataLen; ///< Number of bytes in the segment.
+} CC_Mqtt5DataSegment;
+
 /// @brief Configuration structure to be passed to the @b cc_mqtt5_client_connect_config_basic().
 /// @see @b cc_mqtt5_client_connect_init_config_basic()
 /// @ingroup connect
@@ -447,6 +475,7 @@ typedef struct
     unsigned m_correlationDataLen; ///< Amount of "Correlation Data" bytes;
     const CC_Mqtt5UserProp* m_userProps; ///< Pointer to the "User Property" properties array when provided, NULL if not.
     unsigned m_userPropsCount; ///< Amount of "User Property" properties
+    CC_Mqtt5LazyUserPropsHandle m_lazyUserProps; ///< Handle of the not yet decoded "User Property" properties when lazy decoding is enabled, NULL if none.
     const char* m_contentType; ///< "Content Type" property if provided, NULL if not.
     const unsigned* m_subIds; ///< Pointer to array containing "Subscription Identifier" properties list when provided, NULL if not.
     unsigned m_subIdsCount; ///< Amount of "Subscription Identifiers" in array.
@@ -467,6 +496,7 @@ typedef struct
     CC_Mqtt5QoS m_qos; ///< Publish QoS value, defaults to @ref CC_Mqtt5QoS_AtMostOnceDelivery.
     CC_Mqtt5TopicAliasPreference m_topicAliasPref; ///< Topic alias usage preference, defaults to @ref CC_Mqtt5TopicAliasPreference_UseAliasIfAvailable.
     bool m_retain; ///< "Retain" flag, defaults to false.
+    bool m_borrowData; ///< Don't copy the publish data buffer, it must remain valid until the publish completion is reported, defaults to false.
 } CC_Mqtt5PublishBasicConfig;
 
 /// @brief Configuration structure to be passed to the @b cc_mqtt5_client_publish_config_extra().
@@ -490,6 +520,7 @@ typedef struct
     const char* m_reasonStr; ///< "Reason String" property, can be NULL.
     const CC_Mqtt5UserProp* m_userProps; ///< Pointer to array of "User Properties", can be NULL
     unsigned m_userPropsCount; ///< Number of elements in "User Properties" array.
+    CC_Mqtt5LazyUserPropsHandle m_lazyUserProps; ///< Handle of the not yet decoded "User Properties" when lazy decoding is enabled, NULL if none.
 } CC_Mqtt5PublishResponse;
 
 /// @brief Callback used to request time measurement.
@@ -526,6 +557,42 @@ typedef unsigned (*CC_Mqtt5CancelNextTickWaitCb)(void* data);
 /// @ingroup client
 typedef void (*CC_Mqtt5SendOutputDataCb)(void* data, const unsigned char* buf, unsigned bufLen);
 
+/// @brief Callback used to request sending of the output data split into multiple segments.
+/// @details The segments are expected to be sent in the reported order one after another
+///     (for example using the @b writev() or @b sendmsg() system calls). The segments may
+///     reference the payload buffers of the publish operations configured with the
+///     @ref CC_Mqtt5PublishBasicConfig::m_borrowData set, which allows avoiding the copy of their data.
+///     Assigned using cc_mqtt5_client_set_send_output_data_v_callback() function.
+/// @param[in] data Pointer to user data object, passed as last parameter to
+///     cc_mqtt5_client_set_send_output_data_v_callback() function.
+/// @param[in] segments Pointer to the array of the data segments.
+/// @param[in] count Number of the segments in the array.
+/// @post The segments data can be deallocated / overwritten after the callback function returns.
+/// @ingroup client
+typedef void (*CC_Mqtt5SendOutputDataVCb)(void* data, const CC_Mqtt5DataSegment* segments, unsigned count);
+
+/// @brief Callback used to request the application provided buffer for the output data serialization.
+/// @details Assigned using cc_mqtt5_client_set_output_buf_provider_callbacks() function.
+///     Every successful invocation is followed by the invocation of the @ref CC_Mqtt5OutputBufCommitCb
+///     callback before any other output is reported.
+/// @param[in] data Pointer to user data object, passed as last parameter to
+///     cc_mqtt5_client_set_output_buf_provider_callbacks() function.
+/// @param[in] len Number of bytes required.
+/// @return Pointer to the buffer which can accommodate at least @b len bytes,
+///     @b NULL if not available (the internal output buffer is going to be used instead).
+/// @ingroup client
+typedef unsigned char* (*CC_Mqtt5OutputBufReserveCb)(void* data, unsigned len);
+
+/// @brief Callback used to report the completion of the output data serialization into
+///     the buffer returned by the @ref CC_Mqtt5OutputBufReserveCb callback.
+/// @details Assigned using cc_mqtt5_client_set_output_buf_provider_callbacks() function.
+/// @param[in] data Pointer to user data object, passed as last parameter to
+///     cc_mqtt5_client_set_output_buf_provider_callbacks() function.
+/// @param[in] len Number of bytes written into the buffer and ready to be sent,
+///     @b 0 when the reservation is discarded due to an error.
+/// @ingroup client
+typedef void (*CC_Mqtt5OutputBufCommitCb)(void* data, unsigned len);
+
 /// @brief Callback used to report unsolicited disconnection of the broker.
 /// @details When invoked the "info" is present <b>if and only if</b> the
 ///     broker disconnection report is due to the reception of the @b DISCONNECT
@@ -547,6 +614,15 @@ typedef void (*CC_Mqtt5BrokerDisconnectReportCb)(void* data, CC_Mqtt5BrokerDisco
 /// @ingroup client
 typedef void (*CC_Mqtt5MessageReceivedReportCb)(void* data, const CC_Mqtt5MessageInfo* info);
 
+/// @brief Callback used to report multiple messages received of the broker at once.
+/// @param[in] data Pointer to user data object, passed as the last parameter to
+///     the request call.
+/// @param[in] infos Array of messages information. Will NOT be NULL.
+/// @param[in] count Amount of messages in the array, greater than 0.
+/// @post The data members of the reported infos can NOT be accessed after the function returns.
+/// @ingroup client
+typedef void (*CC_Mqtt5MessagesReceivedReportCb)(void* data, const CC_Mqtt5MessageInfo* infos, unsigned count);
+
 /// @brief Callback used to report discovered errors.
 /// @param[in] data Pointer to user data object, passed as the last parameter to
 ///     the request call.
@@ -74,4 +74,7 @@ set (CC_MQTT5_CLIENT_HAS_SUB_TOPIC_VERIFICATION FALSE)
 #set (CC_MQTT5_CLIENT_SUB_FILTERS_LIMIT 20)
 
 # Limit to QoS1
-set (CC_MQTT5_CLIENT_MAX_QOS 1)
\ No newline at end of file
+set (CC_MQTT5_CLIENT_MAX_QOS 1)
+
+# Limit the amount of publish templates
+set (CC_MQTT5_CLIENT_PUBLISH_TEMPLATES_LIMIT 2)
\ No newline at end of file
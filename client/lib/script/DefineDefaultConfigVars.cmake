@@ -12,6 +12,8 @@ endmacro()
 
 set_default_var_value(CC_MQTT5_CLIENT_CUSTOM_NAME "")
 set_default_var_value(CC_MQTT5_CLIENT_HAS_DYN_MEM_ALLOC TRUE)
+set_default_var_value(CC_MQTT5_CLIENT_HAS_IN_PLACE_MSG_ALLOC FALSE)
+set_default_var_value(CC_MQTT5_CLIENT_HAS_ZERO_COPY_RECV FALSE)
 set_default_var_value(CC_MQTT5_CLIENT_ALLOC_LIMIT 0)
 set_default_var_value(CC_MQTT5_CLIENT_STRING_FIELD_FIXED_LEN 0)
 set_default_var_value(CC_MQTT5_CLIENT_CLIENT_ID_FIELD_FIXED_LEN 0)
@@ -21,6 +23,7 @@ set_default_var_value(CC_MQTT5_CLIENT_TOPIC_FIELD_FIXED_LEN 0)
 set_default_var_value(CC_MQTT5_CLIENT_PROPERTIES_LIST_FIELD_FIXED_LEN 0)
 set_default_var_value(CC_MQTT5_CLIENT_BIN_DATA_FIELD_FIXED_LEN 0)
 set_default_var_value(CC_MQTT5_CLIENT_MAX_OUTPUT_PACKET_SIZE 0)
+set_default_var_value(CC_MQTT5_CLIENT_MAX_INPUT_PACKET_SIZE 0)
 set_default_var_value(CC_MQTT5_CLIENT_HAS_USER_PROPS TRUE)
 set_default_var_value(CC_MQTT5_CLIENT_USER_PROPS_LIMIT 0)
 set_default_var_value(CC_MQTT5_CLIENT_RECEIVE_MAX_LIMIT 0)
@@ -35,4 +38,6 @@ set_default_var_value(CC_MQTT5_CLIENT_HAS_ERROR_LOG TRUE)
 set_default_var_value(CC_MQTT5_CLIENT_HAS_TOPIC_FORMAT_VERIFICATION TRUE)
 set_default_var_value(CC_MQTT5_CLIENT_HAS_SUB_TOPIC_VERIFICATION TRUE)
 set_default_var_value(CC_MQTT5_CLIENT_SUB_FILTERS_LIMIT 0)
-set_default_var_value(CC_MQTT5_CLIENT_MAX_QOS 2)
\ No newline at end of file
+set_default_var_value(CC_MQTT5_CLIENT_MAX_QOS 2)
+set_default_var_value(CC_MQTT5_CLIENT_PUBLISH_TEMPLATES_LIMIT 0)
+set_default_var_value(CC_MQTT5_CLIENT_RECYCLED_OBJS_LIMIT 0)
\ No newline at end of file
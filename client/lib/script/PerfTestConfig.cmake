@@ -0,0 +1,11 @@
+# Name of the client API
+set (CC_MQTT5_CLIENT_CUSTOM_NAME "perf")
+
+# Reuse the client's own storage for the incoming messages
+set (CC_MQTT5_CLIENT_HAS_IN_PLACE_MSG_ALLOC TRUE)
+
+# Reference the incoming PUBLISH binary data directly in the input buffer
+set (CC_MQTT5_CLIENT_HAS_ZERO_COPY_RECV TRUE)
+
+# Keep up to 128 released objects of every type for reuse
+set (CC_MQTT5_CLIENT_RECYCLED_OBJS_LIMIT 128)
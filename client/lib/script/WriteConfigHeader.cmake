@@ -34,6 +34,8 @@ macro (adjust_bool_value name adjusted_name)
 endmacro ()
 
 adjust_bool_value ("CC_MQTT5_CLIENT_HAS_DYN_MEM_ALLOC" "CC_MQTT5_CLIENT_HAS_DYN_MEM_ALLOC_CPP")
+adjust_bool_value ("CC_MQTT5_CLIENT_HAS_IN_PLACE_MSG_ALLOC" "CC_MQTT5_CLIENT_HAS_IN_PLACE_MSG_ALLOC_CPP")
+adjust_bool_value ("CC_MQTT5_CLIENT_HAS_ZERO_COPY_RECV" "CC_MQTT5_CLIENT_HAS_ZERO_COPY_RECV_CPP")
 adjust_bool_value ("CC_MQTT5_CLIENT_HAS_USER_PROPS" "CC_MQTT5_CLIENT_HAS_USER_PROPS_CPP")
 adjust_bool_value ("CC_MQTT5_CLIENT_HAS_TOPIC_ALIASES" "CC_MQTT5_CLIENT_HAS_TOPIC_ALIASES_CPP")
 adjust_bool_value ("CC_MQTT5_CLIENT_HAS_SUB_IDS" "CC_MQTT5_CLIENT_HAS_SUB_IDS_CPP")
@@ -44,11 +46,14 @@ adjust_bool_value ("CC_MQTT5_CLIENT_HAS_SUB_TOPIC_VERIFICATION" "CC_MQTT5_CLIENT
 #########################################
 
 replace_in_text (CC_MQTT5_CLIENT_HAS_DYN_MEM_ALLOC_CPP)
+replace_in_text (CC_MQTT5_CLIENT_HAS_IN_PLACE_MSG_ALLOC_CPP)
+replace_in_text (CC_MQTT5_CLIENT_HAS_ZERO_COPY_RECV_CPP)
 replace_in_text (CC_MQTT5_CLIENT_ALLOC_LIMIT)
 replace_in_text (CC_MQTT5_CLIENT_STRING_FIELD_FIXED_LEN)
 replace_in_text (CC_MQTT5_CLIENT_PROPERTIES_LIST_FIELD_FIXED_LEN)
 replace_in_text (CC_MQTT5_CLIENT_BIN_DATA_FIELD_FIXED_LEN)
 replace_in_text (CC_MQTT5_CLIENT_MAX_OUTPUT_PACKET_SIZE)
+replace_in_text (CC_MQTT5_CLIENT_MAX_INPUT_PACKET_SIZE)
 replace_in_text (CC_MQTT5_CLIENT_HAS_USER_PROPS_CPP)
 replace_in_text (CC_MQTT5_CLIENT_USER_PROPS_LIMIT)
 replace_in_text (CC_MQTT5_CLIENT_RECEIVE_MAX_LIMIT)
@@ -64,6 +69,8 @@ replace_in_text (CC_MQTT5_CLIENT_HAS_TOPIC_FORMAT_VERIFICATION_CPP)
 replace_in_text (CC_MQTT5_CLIENT_HAS_SUB_TOPIC_VERIFICATION_CPP)
 replace_in_text (CC_MQTT5_CLIENT_SUB_FILTERS_LIMIT)
 replace_in_text (CC_MQTT5_CLIENT_MAX_QOS)
+replace_in_text (CC_MQTT5_CLIENT_PUBLISH_TEMPLATES_LIMIT)
+replace_in_text (CC_MQTT5_CLIENT_RECYCLED_OBJS_LIMIT)
 
 file (WRITE "${OUT_FILE}.tmp" "${text}")
 
@@ -47,6 +47,9 @@ set_default_opt (MESSAGE_UNSUBSCRIBE_FIELDS_LIST)
 set_default_opt (MAX_PACKET_SIZE)
 set_default_opt (MSG_ALLOC_OPT)
 
+set_default_opt (RECV_PUBLISH_FIELD_BIN_DATA)
+set_default_opt (RECV_PUBLISH_MESSAGE_PUBLISH_FIELDS_PAYLOAD)
+
 #########################################
 
 # Update options
@@ -54,6 +57,8 @@ set_default_opt (MSG_ALLOC_OPT)
 if (NOT ${CC_MQTT5_CLIENT_HAS_DYN_MEM_ALLOC})
     set (FIELD_PROTOCOL_NAME "comms::option::app::FixedSizeStorage<4>")
     set (MSG_ALLOC_OPT "comms::option::app::InPlaceAllocation")
+elseif (${CC_MQTT5_CLIENT_HAS_IN_PLACE_MSG_ALLOC})
+    set (MSG_ALLOC_OPT "comms::option::app::InPlaceAllocation")
 endif ()
 
 if (NOT ${CC_MQTT5_CLIENT_BIN_DATA_FIELD_FIXED_LEN} EQUAL 0)
@@ -117,6 +122,11 @@ elseif (NOT ${CC_MQTT5_CLIENT_HAS_DYN_MEM_ALLOC})
     message (FATAL_ERROR "When dynamic memory allocation is disabled, the CC_MQTT5_CLIENT_ASYNC_UNSUBS_LIMIT needs to be set")
 endif ()
 
+if (${CC_MQTT5_CLIENT_HAS_ZERO_COPY_RECV})
+    set (RECV_PUBLISH_FIELD_BIN_DATA "comms::option::app::OrigDataView")
+    set (RECV_PUBLISH_MESSAGE_PUBLISH_FIELDS_PAYLOAD "comms::option::app::OrigDataView")
+endif ()
+
 #########################################
 
 replace_in_text (FIELD_BIN_DATA)
@@ -135,6 +145,9 @@ replace_in_text (MESSAGE_UNSUBSCRIBE_FIELDS_LIST)
 replace_in_text (MAX_PACKET_SIZE)
 replace_in_text (MSG_ALLOC_OPT)
 
+replace_in_text (RECV_PUBLISH_FIELD_BIN_DATA)
+replace_in_text (RECV_PUBLISH_MESSAGE_PUBLISH_FIELDS_PAYLOAD)
+
 file (WRITE "${OUT_FILE}.tmp" "${text}")
 
 execute_process(
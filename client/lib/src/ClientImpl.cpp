@@ -13,6 +13,10 @@
 #include "comms/util/ScopeGuard.h"
 
 #include <algorithm>
+#include <array>
+#include <functional>
+#include <iterator>
+#include <limits>
 #include <type_traits>
 
 namespace cc_mqtt5_client
@@ -49,12 +53,95 @@ void updateEc(CC_Mqtt5ErrorCode* ec, CC_Mqtt5ErrorCode val)
     }
 }
 
+using FixedHeaderBuf = std::array<std::uint8_t, 5U>;
+
+// Re-encode the fixed header of the serialized message to make its
+// "Remaining Length" account for the separately reported payload.
+// Returns the length of the new fixed header (0 on error) and updates
+// the origLen with the length of the original one.
+std::size_t updateFixedHeader(const std::uint8_t* buf, std::size_t len, std::size_t extraLen, FixedHeaderBuf& header, std::size_t& origLen)
+{
+    std::size_t remLen = 0U;
+    std::size_t idx = 1U;
+    unsigned shift = 0U;
+    while (true) {
+        if ((len <= idx) || (header.size() <= idx)) {
+            return 0U;
+        }
+
+        auto byte = buf[idx];
+        ++idx;
+        remLen |= static_cast<std::size_t>(byte & 0x7fU) << shift;
+        shift += 7U;
+        if ((byte & 0x80U) == 0U) {
+            break;
+        }
+    }
+
+    origLen = idx;
+    remLen += extraLen;
+
+    static constexpr std::size_t MaxRemLen = 268435455U;
+    if (MaxRemLen < remLen) {
+        return 0U;
+    }
+
+    header[0] = buf[0];
+    std::size_t headerLen = 1U;
+    do {
+        auto byte = static_cast<std::uint8_t>(remLen & 0x7fU);
+        remLen >>= 7U;
+        if (remLen > 0U) {
+            byte |= 0x80U;
+        }
+
+        header[headerLen] = byte;
+        ++headerLen;
+    } while (remLen > 0U);
+
+    return headerLen;
+}
+
+std::size_t remLenFieldLen(std::size_t remLen)
+{
+    std::size_t result = 1U;
+    while (remLen >= 0x80U) {
+        remLen >>= 7U;
+        ++result;
+    }
+
+    return result;
+}
+
+// Calculate by how many bytes the fixed header of the serialized message of
+// the provided length grows when the extra payload is appended.
+std::size_t fixedHeaderGrowth(std::size_t len, std::size_t extraLen)
+{
+    if (extraLen == 0U) {
+        return 0U;
+    }
+
+    for (std::size_t fieldLen = 1U; (fieldLen < FixedHeaderBuf().size()) && (fieldLen < len); ++fieldLen) {
+        auto remLen = len - 1U - fieldLen;
+        if (remLenFieldLen(remLen) == fieldLen) {
+            return remLenFieldLen(remLen + extraLen) - fieldLen;
+        }
+    }
+
+    [[maybe_unused]] static constexpr bool ShouldNotHappen = false;
+    COMMS_ASSERT(ShouldNotHappen);
+    return 0U;
+}
+
 } // namespace
 
 ClientImpl::ClientImpl() :
-    m_sessionExpiryTimer(m_timerMgr.allocTimer())
+    m_responseTimeouts(m_timerMgr),
+    m_sessionExpiryTimer(m_timerMgr.allocTimer()),
+    m_recvQos2Timer(m_timerMgr.allocTimer())
 {
     COMMS_ASSERT(m_sessionExpiryTimer.isValid());
+    COMMS_ASSERT(m_recvQos2Timer.isValid());
 }
 
 ClientImpl::~ClientImpl()
@@ -72,6 +159,14 @@ void ClientImpl::tick(unsigned ms)
 }
 
 unsigned ClientImpl::processData(const std::uint8_t* iter, unsigned len)
+{
+    auto segment = CC_Mqtt5DataSegment();
+    segment.m_data = iter;
+    segment.m_dataLen = len;
+    return processDataV(&segment, 1U);
+}
+
+unsigned ClientImpl::processDataV(const CC_Mqtt5DataSegment* segments, unsigned count)
 {
     auto guard = apiEnter();
     COMMS_ASSERT(!m_clientState.m_networkDisconnected);
@@ -81,7 +176,17 @@ unsigned ClientImpl::processData(const std::uint8_t* iter, unsigned len)
         return 0U;
     }
 
-    auto disconnectReason = DisconnectMsg::Field_reasonCode::Field::ValueType::ProtocolError;
+    unsigned totalLen = 0U;
+    for (auto idx = 0U; idx < count; ++idx) {
+        if ((std::numeric_limits<unsigned>::max() - totalLen) < segments[idx].m_dataLen) {
+            errorLog("Total length of the data segments is too big.");
+            return 0U;
+        }
+
+        totalLen += segments[idx].m_dataLen;
+    }
+
+    auto disconnectReason = DisconnectReason::ProtocolError;
     auto disconnectOnExitGuard =
         comms::util::makeScopeGuard(
             [this, &disconnectReason]()
@@ -90,69 +195,75 @@ unsigned ClientImpl::processData(const std::uint8_t* iter, unsigned len)
                 brokerDisconnected(CC_Mqtt5BrokerDisconnectReason_ProtocolError, CC_Mqtt5AsyncOpStatus_ProtocolError);
             });
 
-    unsigned consumed = 0;
-    while (consumed < len) {
-        auto remLen = len - consumed;
-        auto* iterTmp = iter;
+    auto reportMsgsBatchOnExitGuard =
+        comms::util::makeScopeGuard(
+            [this]()
+            {
+                reportMsgsBatch();
+            });
 
-        using IdAndFlagsField = ProtFrame::Layer_idAndFlags::Field;
-        static_assert(IdAndFlagsField::minLength() == IdAndFlagsField::maxLength());
+    bool incremental = false;
+    if constexpr (ExtConfig::HasIncrementalRecv) {
+        incremental = m_configState.m_incrementalRecv;
+    }
 
-        if (remLen <= IdAndFlagsField::minLength()) {
-            // Size info is not available
-            break;
+    unsigned unconsumed = 0U;
+    for (auto idx = 0U; idx < count; ++idx) {
+        auto* iter = segments[idx].m_data;
+        auto len = segments[idx].m_dataLen;
+
+        if (!completeStoredFrame(iter, len, disconnectReason)) {
+            return totalLen;
         }
 
-        using SizeField = ProtFrame::Layer_size::Field;
-        SizeField sizeField;
-        std::advance(iterTmp, IdAndFlagsField::minLength());
-        auto es = sizeField.read(iterTmp, remLen - IdAndFlagsField::minLength());
-        if (es == comms::ErrorStatus::NotEnoughData) {
-            break;
+        if (len == 0U) {
+            continue;
         }
 
-        if (es != comms::ErrorStatus::Success) {
-            return len; // Disconnect
+        unsigned consumed = 0U;
+        if (!processFrames(iter, len, consumed, disconnectReason)) {
+            return totalLen;
         }
 
-        if (m_sessionState.m_maxRecvPacketSize > 0U) {
-            auto prefixSize = IdAndFlagsField::minLength() + sizeField.length();
-            COMMS_ASSERT(prefixSize <= m_sessionState.m_maxRecvPacketSize);
+        if (len <= consumed) {
+            continue;
+        }
 
-            auto maxAllowedSize = m_sessionState.m_maxRecvPacketSize - prefixSize;
-            if (maxAllowedSize < sizeField.value()) {
-                errorLog("The message length exceeded max packet size");
-                disconnectReason = DisconnectMsg::Field_reasonCode::Field::ValueType::PacketTooLarge;
-                return len;
+        auto remLen = len - consumed;
+        bool lastSegment = ((idx + 1U) == count);
+        bool canStore = (std::max(remLen, m_pendingFrameLen) <= m_inputBuf.max_size());
+        if ((!incremental) && (lastSegment || (!canStore))) {
+            // The rest needs to be reported again by the application
+            for (auto restIdx = idx + 1U; restIdx < count; ++restIdx) {
+                remLen += segments[restIdx].m_dataLen;
             }
-        }
 
-        iterTmp = iter;
-        ProtFrame::MsgPtr msg;
-        es = m_frame.read(msg, iterTmp, remLen);
-        if (es == comms::ErrorStatus::NotEnoughData) {
+            unconsumed = remLen;
             break;
         }
 
-        if (es != comms::ErrorStatus::Success) {
-            errorLog("Unexpected error in framing / payload parsing");
-            return len;
+        if (!storeIncompleteFrame(iter + consumed, remLen, disconnectReason)) {
+            return totalLen;
         }
+    }
 
-        COMMS_ASSERT(msg);
-        msg->dispatch(*this);
-        consumed += static_cast<unsigned>(std::distance(iter, iterTmp));
-        iter = iterTmp;
+    if (!incremental) {
+        // Incomplete packet split between segments, needs to be reported again.
+        unconsumed += static_cast<unsigned>(m_inputBuf.size());
+        m_inputBuf.clear();
     }
 
     disconnectOnExitGuard.release();
-    return consumed;
+    return totalLen - unconsumed;
 }
 
 void ClientImpl::notifyNetworkDisconnected()
 {
     auto guard = apiEnter();
     m_clientState.m_networkDisconnected = true;
+    m_pendingFrameLen = 0U;
+    m_inputBuf.clear();
+    m_buf.clear(); // Corked output cannot be delivered any more
     if (m_sessionState.m_disconnecting) {
         return; // No need to go through broker disconnection
     }
@@ -165,6 +276,131 @@ bool ClientImpl::isNetworkDisconnected() const
     return m_clientState.m_networkDisconnected;
 }
 
+CC_Mqtt5ErrorCode ClientImpl::setIncrementalRecvEnabled(bool enabled)
+{
+    if constexpr (ExtConfig::HasIncrementalRecv) {
+        if ((!enabled) && (!m_inputBuf.empty())) {
+            errorLog("Cannot disable incremental data processing while incomplete packet is stored.");
+            return CC_Mqtt5ErrorCode_Busy;
+        }
+
+        m_configState.m_incrementalRecv = enabled;
+        return CC_Mqtt5ErrorCode_Success;
+    }
+    else {
+        if (enabled) {
+            errorLog("Incremental data processing is not supported.");
+            return CC_Mqtt5ErrorCode_NotSupported;
+        }
+
+        return CC_Mqtt5ErrorCode_Success;
+    }
+}
+
+CC_Mqtt5ErrorCode ClientImpl::setMessagesReceivedCallback(CC_Mqtt5MessagesReceivedReportCb cb, void* data)
+{
+    if constexpr (ExtConfig::HasMsgsBatch) {
+        if (!m_batchedMsgs.empty()) {
+            errorLog("Cannot update messages received callback while reporting messages.");
+            return CC_Mqtt5ErrorCode_Busy;
+        }
+
+        m_messagesReceivedReportCb = cb;
+        m_messagesReceivedReportData = data;
+        return CC_Mqtt5ErrorCode_Success;
+    }
+    else {
+        if (cb != nullptr) {
+            errorLog("Batched report of the received messages is not supported.");
+            return CC_Mqtt5ErrorCode_NotSupported;
+        }
+
+        static_cast<void>(data);
+        return CC_Mqtt5ErrorCode_Success;
+    }
+}
+
+CC_Mqtt5ErrorCode ClientImpl::setAutoCorkEnabled(bool enabled)
+{
+    if constexpr (ExtConfig::HasAutoCork) {
+        m_configState.m_autoCork = enabled;
+        return CC_Mqtt5ErrorCode_Success;
+    }
+    else {
+        if (enabled) {
+            errorLog("Automatic corking of the output is not supported.");
+            return CC_Mqtt5ErrorCode_NotSupported;
+        }
+
+        return CC_Mqtt5ErrorCode_Success;
+    }
+}
+
+void ClientImpl::cork()
+{
+    m_outputCorked = true;
+}
+
+void ClientImpl::uncork()
+{
+    auto guard = apiEnter();
+    m_outputCorked = false;
+    if (!isOutputCorked()) {
+        flushOutput();
+    }
+}
+
+CC_Mqtt5ErrorCode ClientImpl::setLazyPropsEnabled(bool enabled)
+{
+    if constexpr (Config::HasUserProps) {
+        m_configState.m_lazyProps = enabled;
+        return CC_Mqtt5ErrorCode_Success;
+    }
+    else {
+        if (enabled) {
+            errorLog("Lazy properties decoding is not supported.");
+            return CC_Mqtt5ErrorCode_NotSupported;
+        }
+
+        return CC_Mqtt5ErrorCode_Success;
+    }
+}
+
+CC_Mqtt5ErrorCode ClientImpl::fetchUserProps(op::Op::LazyUserProps* lazyProps, const CC_Mqtt5UserProp** props, unsigned* count)
+{
+    if ((props == nullptr) || (count == nullptr)) {
+        errorLog("Output parameters for user properties are not provided.");
+        return CC_Mqtt5ErrorCode_BadParam;
+    }
+
+    *props = nullptr;
+    *count = 0U;
+
+    if (lazyProps == nullptr) {
+        // No deferred user properties in the reported message
+        return CC_Mqtt5ErrorCode_Success;
+    }
+
+    if constexpr (Config::HasUserProps) {
+        COMMS_ASSERT(lazyProps->m_userProps != nullptr);
+        auto& userProps = *lazyProps->m_userProps;
+        if (lazyProps->m_fillFunc != nullptr) {
+            // Decoded only on the first fetch
+            COMMS_ASSERT(lazyProps->m_src != nullptr);
+            userProps.clear();
+            lazyProps->m_fillFunc(lazyProps->m_src, userProps);
+            lazyProps->m_fillFunc = nullptr;
+        }
+
+        if (!userProps.empty()) {
+            *props = &userProps[0];
+            comms::cast_assign(*count) = userProps.size();
+        }
+    }
+
+    return CC_Mqtt5ErrorCode_Success;
+}
+
 op::ConnectOp* ClientImpl::connectPrepare(CC_Mqtt5ErrorCode* ec)
 {
     op::ConnectOp* connectOp = nullptr;
@@ -224,7 +460,7 @@ op::ConnectOp* ClientImpl::connectPrepare(CC_Mqtt5ErrorCode* ec)
         }
 
         m_preparationLocked = true;
-        m_ops.push_back(ptr.get());
+        addOp(ptr.get());
         m_connectOps.push_back(std::move(ptr));
         connectOp = m_connectOps.back().get();
         updateEc(ec, CC_Mqtt5ErrorCode_Success);
@@ -281,7 +517,7 @@ op::DisconnectOp* ClientImpl::disconnectPrepare(CC_Mqtt5ErrorCode* ec)
         }
 
         m_preparationLocked = true;
-        m_ops.push_back(ptr.get());
+        addOp(ptr.get());
         m_disconnectOps.push_back(std::move(ptr));
         disconnectOp = m_disconnectOps.back().get();
         updateEc(ec, CC_Mqtt5ErrorCode_Success);
@@ -332,7 +568,7 @@ op::SubscribeOp* ClientImpl::subscribePrepare(CC_Mqtt5ErrorCode* ec)
         }
 
         m_preparationLocked = true;
-        m_ops.push_back(ptr.get());
+        addOp(ptr.get());
         m_subscribeOps.push_back(std::move(ptr));
         subOp = m_subscribeOps.back().get();
         updateEc(ec, CC_Mqtt5ErrorCode_Success);
@@ -383,7 +619,7 @@ op::UnsubscribeOp* ClientImpl::unsubscribePrepare(CC_Mqtt5ErrorCode* ec)
         }
 
         m_preparationLocked = true;
-        m_ops.push_back(ptr.get());
+        addOp(ptr.get());
         m_unsubscribeOps.push_back(std::move(ptr));
         unsubOp = m_unsubscribeOps.back().get();
         updateEc(ec, CC_Mqtt5ErrorCode_Success);
@@ -394,111 +630,433 @@ op::UnsubscribeOp* ClientImpl::unsubscribePrepare(CC_Mqtt5ErrorCode* ec)
 
 op::SendOp* ClientImpl::publishPrepare(CC_Mqtt5ErrorCode* ec)
 {
-    op::SendOp* sendOp = nullptr;
-    do {
-        if (!m_sessionState.m_connected) {
-            errorLog("Client must be connected to allow publish.");
-            updateEc(ec, CC_Mqtt5ErrorCode_NotConnected);
-            break;
-        }
+    if (!isPublishAllowed(ec)) {
+        return nullptr;
+    }
 
-        if (m_sessionState.m_disconnecting) {
-            errorLog("Session disconnection is in progress, cannot initiate publish.");
-            updateEc(ec, CC_Mqtt5ErrorCode_Disconnecting);
-            break;
-        }
+    return allocSendOp(ec);
+}
 
-        if (m_clientState.m_networkDisconnected) {
-            errorLog("Network is disconnected.");
-            updateEc(ec, CC_Mqtt5ErrorCode_NetworkDisconnected);
-            break;
+CC_Mqtt5ErrorCode ClientImpl::publishBatch(
+    const CC_Mqtt5PublishBasicConfig* basicConfigs,
+    const CC_Mqtt5PublishExtraConfig* extraConfigs,
+    unsigned count,
+    CC_Mqtt5PublishCompleteCb cb,
+    void* cbData,
+    unsigned* sentCount)
+{
+    if (sentCount != nullptr) {
+        *sentCount = 0U;
+    }
+
+    if ((count > 0U) && (basicConfigs == nullptr)) {
+        errorLog("Publish configurations are not provided.");
+        return CC_Mqtt5ErrorCode_BadParam;
+    }
+
+    auto ec = CC_Mqtt5ErrorCode_Success;
+    if (!isPublishAllowed(&ec)) {
+        return ec;
+    }
+
+    // Single entry: the timer is re-programmed and the output is flushed once
+    // when the guard is released.
+    auto guard = apiEnter();
+    auto wasBatched = m_outputBatched;
+    m_outputBatched = true;
+    auto unbatchOnExit =
+        comms::util::makeScopeGuard(
+            [this, wasBatched]()
+            {
+                m_outputBatched = wasBatched;
+            });
+
+    for (auto idx = 0U; idx < count; ++idx) {
+        auto transientOp = allocTransientSendOp(basicConfigs[idx].m_qos);
+        if (transientOp) {
+            ec = transientOp->configBasic(basicConfigs[idx]);
+            if ((ec == CC_Mqtt5ErrorCode_Success) && (extraConfigs != nullptr)) {
+                ec = transientOp->configExtra(extraConfigs[idx]);
+            }
+
+            if (ec == CC_Mqtt5ErrorCode_Success) {
+                ec = transientOp->sendTransient(cb, cbData);
+            }
         }
+        else {
+            if ((m_apiEnterCount == 1U) &&
+                ((m_ops.max_size() <= m_ops.size()) || (m_sendOps.max_size() <= m_sendOps.size()))) {
+                // Not invoked from within a callback, the completed operations can be removed
+                cleanOps(true);
+            }
 
-        if (m_ops.max_size() <= m_ops.size()) {
-            errorLog("Cannot start publish operation, retry in next event loop iteration.");
-            updateEc(ec, CC_Mqtt5ErrorCode_RetryLater);
-            break;
+            auto* sendOp = allocSendOp(&ec);
+            if (sendOp == nullptr) {
+                break;
+            }
+
+            ec = sendOp->configBasic(basicConfigs[idx]);
+            if ((ec == CC_Mqtt5ErrorCode_Success) && (extraConfigs != nullptr)) {
+                ec = sendOp->configExtra(extraConfigs[idx]);
+            }
+
+            if (ec != CC_Mqtt5ErrorCode_Success) {
+                sendOp->cancel();
+                break;
+            }
+
+            ec = sendOp->send(cb, cbData);
         }
 
-        auto ptr = m_sendOpsAlloc.alloc(*this);
-        if (!ptr) {
-            errorLog("Cannot allocate new publish operation.");
-            updateEc(ec, CC_Mqtt5ErrorCode_OutOfMemory);
+        if (ec != CC_Mqtt5ErrorCode_Success) {
             break;
         }
 
-        if (m_preparationLocked) {
-            errorLog("Another operation is being prepared, cannot prepare \"unsubscribe\" without \"send\" or \"cancel\" of the previous.");
-            updateEc(ec, CC_Mqtt5ErrorCode_PreparationLocked);
-            break;
+        if (sentCount != nullptr) {
+            ++(*sentCount);
         }
 
-        m_preparationLocked = true;
-        m_ops.push_back(ptr.get());
-        m_sendOps.push_back(std::move(ptr));
-        sendOp = m_sendOps.back().get();
-        updateEc(ec, CC_Mqtt5ErrorCode_Success);
-    } while (false);
+        // The completion callback may change the connection state
+        if ((idx + 1U) < count) {
+            if (!isPublishAllowed(&ec)) {
+                break;
+            }
+        }
+    }
 
-    return sendOp;
+    return ec;
 }
 
-op::ReauthOp* ClientImpl::reauthPrepare(CC_Mqtt5ErrorCode* ec)
+bool ClientImpl::isPublishAllowed(CC_Mqtt5ErrorCode* ec)
 {
-    op::ReauthOp* reauthOp = nullptr;
-    do {
-        if (!m_reauthOps.empty()) {
-            // Already allocated
-            errorLog("Another reauth operation is in progress.");
-            updateEc(ec, CC_Mqtt5ErrorCode_Busy);
-            break;
-        }
+    if (!m_sessionState.m_connected) {
+        errorLog("Client must be connected to allow publish.");
+        updateEc(ec, CC_Mqtt5ErrorCode_NotConnected);
+        return false;
+    }
 
-        if (!m_sessionState.m_connected) {
-            errorLog("Client must be connected to allow reauth.");
-            updateEc(ec, CC_Mqtt5ErrorCode_NotConnected);
-            break;
-        }
+    if (m_sessionState.m_disconnecting) {
+        errorLog("Session disconnection is in progress, cannot initiate publish.");
+        updateEc(ec, CC_Mqtt5ErrorCode_Disconnecting);
+        return false;
+    }
 
-        if (m_sessionState.m_disconnecting) {
-            errorLog("Session disconnection is in progress, cannot initiate reauth.");
-            updateEc(ec, CC_Mqtt5ErrorCode_Disconnecting);
-            break;
-        }
+    if (m_clientState.m_networkDisconnected) {
+        errorLog("Network is disconnected.");
+        updateEc(ec, CC_Mqtt5ErrorCode_NetworkDisconnected);
+        return false;
+    }
 
-        if (m_clientState.m_networkDisconnected) {
-            errorLog("Network is disconnected.");
-            updateEc(ec, CC_Mqtt5ErrorCode_NetworkDisconnected);
-            break;
-        }
+    // Also applies to the publishes that don't allocate the operation
+    if (m_preparationLocked) {
+        errorLog("Another operation is being prepared, cannot publish without \"send\" or \"cancel\" of the previous.");
+        updateEc(ec, CC_Mqtt5ErrorCode_PreparationLocked);
+        return false;
+    }
 
-        if (m_sessionState.m_authMethod.empty()) {
-            errorLog("Reauthentication allowed only when CONNECT used authentication.");
-            updateEc(ec, CC_Mqtt5ErrorCode_NotAuthenticated);
-            break;
+    return true;
+}
+
+op::SendOp* ClientImpl::allocSendOp(CC_Mqtt5ErrorCode* ec, PublishMsg* msg)
+{
+    op::SendOp* sendOp = nullptr;
+    do {
+        if (m_sendOps.max_size() <= m_sendOps.size()) {
+            reclaimSendOpsSlots();
         }
 
-        if (m_ops.max_size() <= m_ops.size()) {
-            errorLog("Cannot start reauth operation, retry in next event loop iteration.");
+        if ((m_ops.max_size() <= m_ops.size()) ||
+            (m_sendOps.max_size() <= m_sendOps.size())) {
+            errorLog("Cannot start publish operation, retry in next event loop iteration.");
             updateEc(ec, CC_Mqtt5ErrorCode_RetryLater);
             break;
         }
 
         if (m_preparationLocked) {
-            errorLog("Another operation is being prepared, cannot prepare \"reauth\" without \"send\" or \"cancel\" of the previous.");
+            errorLog("Another operation is being prepared, cannot prepare \"publish\" without \"send\" or \"cancel\" of the previous.");
             updateEc(ec, CC_Mqtt5ErrorCode_PreparationLocked);
             break;
         }
 
-        auto ptr = m_reauthOpsAlloc.alloc(*this);
+        auto ptr = m_sendOpsAlloc.alloc(*this, msg);
         if (!ptr) {
-            errorLog("Cannot allocate new reauth operation.");
+            errorLog("Cannot allocate new publish operation.");
             updateEc(ec, CC_Mqtt5ErrorCode_OutOfMemory);
             break;
         }
 
         m_preparationLocked = true;
-        m_ops.push_back(ptr.get());
+        addOp(ptr.get());
+        ptr->acquireBufs(m_recycledSendBufs);
+        ptr->setSendOpsIdx(static_cast<unsigned>(m_sendOps.size()));
+        m_sendOps.push_back(std::move(ptr));
+        sendOp = m_sendOps.back().get();
+        updateEc(ec, CC_Mqtt5ErrorCode_Success);
+    } while (false);
+
+    return sendOp;
+}
+
+ClientImpl::TransientSendOpAlloc::Ptr ClientImpl::allocTransientSendOp(CC_Mqtt5QoS qos, PublishMsg* msg)
+{
+    // The QoS0 publish doesn't keep any state after being sent, no need
+    // to allocate and register the operation unless it must be queued
+    // behind the in-flight ones to preserve the order.
+    if ((qos != CC_Mqtt5QoS_AtMostOnceDelivery) ||
+        ((m_configState.m_publishOrdering != CC_Mqtt5PublishOrdering_SameQos) && (sendsCount() > 0U))) {
+        return TransientSendOpAlloc::Ptr();
+    }
+
+    if (msg != nullptr) {
+        // Fails when already in use (re-entry from the completion callback)
+        return m_transientSendOpAlloc.alloc(*this, msg);
+    }
+
+    auto op = m_transientSendOpAlloc.alloc(*this, &m_transientPubMsg);
+    if (op) {
+        // Reusing the storage of the previous publish, the flags are set by the configuration
+        m_transientPubMsg.field_topic().value().clear();
+        m_transientPubMsg.field_properties().value().clear();
+        m_transientPubMsg.field_payload().value().clear();
+    }
+
+    return op;
+}
+
+PublishTemplate* ClientImpl::publishTemplateAlloc(
+    const CC_Mqtt5PublishBasicConfig& basic,
+    const CC_Mqtt5PublishExtraConfig* extra,
+    const CC_Mqtt5UserProp* userProps,
+    unsigned userPropsCount,
+    CC_Mqtt5ErrorCode* ec)
+{
+    if constexpr (ExtConfig::HasPublishTemplates) {
+        if (m_publishTemplates.max_size() <= m_publishTemplates.size()) {
+            errorLog("Cannot allocate publish template, reached available limit.");
+            updateEc(ec, CC_Mqtt5ErrorCode_OutOfMemory);
+            return nullptr;
+        }
+
+        if ((userPropsCount > 0U) && (userProps == nullptr)) {
+            errorLog("User properties for publish template are not provided.");
+            updateEc(ec, CC_Mqtt5ErrorCode_BadParam);
+            return nullptr;
+        }
+
+        if constexpr (!Config::HasTopicAliases) {
+            if ((basic.m_topicAliasPref != CC_Mqtt5TopicAliasPreference_UseAliasIfAvailable) &&
+                (basic.m_topicAliasPref != CC_Mqtt5TopicAliasPreference_ForceTopicOnly)) {
+                errorLog("Topic aliases are not supported");
+                updateEc(ec, CC_Mqtt5ErrorCode_NotSupported);
+                return nullptr;
+            }
+        }
+
+        // The template is validated using the temporary publish operation
+        auto* sendOp = publishPrepare(ec);
+        if (sendOp == nullptr) {
+            return nullptr;
+        }
+
+        auto cancelOnExit =
+            comms::util::makeScopeGuard(
+                [sendOp]()
+                {
+                    sendOp->cancel();
+                });
+
+        // The topic alias and the payload are applied on every send
+        auto basicConfig = basic;
+        basicConfig.m_data = nullptr;
+        basicConfig.m_dataLen = 0U;
+        basicConfig.m_topicAliasPref = CC_Mqtt5TopicAliasPreference_ForceTopicOnly;
+
+        auto result = sendOp->configBasic(basicConfig);
+        if ((result == CC_Mqtt5ErrorCode_Success) && (extra != nullptr)) {
+            result = sendOp->configExtra(*extra);
+        }
+
+        for (auto idx = 0U; (idx < userPropsCount) && (result == CC_Mqtt5ErrorCode_Success); ++idx) {
+            result = sendOp->addUserProp(userProps[idx]);
+        }
+
+        if (result != CC_Mqtt5ErrorCode_Success) {
+            updateEc(ec, result);
+            return nullptr;
+        }
+
+        auto ptr = m_publishTemplatesAlloc.alloc();
+        if (!ptr) {
+            errorLog("Cannot allocate new publish template.");
+            updateEc(ec, CC_Mqtt5ErrorCode_OutOfMemory);
+            return nullptr;
+        }
+
+        ptr->m_pubMsg = sendOp->pubMsg();
+        ptr->m_topicAliasPref = basic.m_topicAliasPref;
+        ptr->m_borrowData = basic.m_borrowData;
+
+        auto& propsVec = ptr->m_pubMsg.field_properties().value();
+        auto iter =
+            std::find_if(
+                propsVec.begin(), propsVec.end(),
+                [](auto& prop)
+                {
+                    return (prop.currentField() == PublishMsg::Field_properties::ValueType::value_type::FieldIdx_correlationData);
+                });
+
+        if (iter != propsVec.end()) {
+            ptr->m_correlationDataIdx = static_cast<unsigned>(std::distance(propsVec.begin(), iter));
+        }
+
+        ptr->m_propsCount = static_cast<unsigned>(propsVec.size());
+
+        auto* tmpl = ptr.get();
+        auto tmplIter = findPublishTemplate(tmpl);
+        COMMS_ASSERT((tmplIter == m_publishTemplates.end()) || (tmplIter->get() != tmpl));
+        m_publishTemplates.insert(tmplIter, std::move(ptr));
+        updateEc(ec, CC_Mqtt5ErrorCode_Success);
+        return tmpl;
+    }
+    else {
+        errorLog("Publish templates are not supported.");
+        updateEc(ec, CC_Mqtt5ErrorCode_NotSupported);
+        return nullptr;
+    }
+}
+
+CC_Mqtt5ErrorCode ClientImpl::publishTemplateFree(PublishTemplate* tmpl)
+{
+    // The handle is not dereferenced before it is found, it may be already freed
+    auto iter = findPublishTemplate(tmpl);
+    if ((iter == m_publishTemplates.end()) || (iter->get() != tmpl)) {
+        errorLog("Unknown publish template.");
+        return CC_Mqtt5ErrorCode_BadParam;
+    }
+
+    m_publishTemplates.erase(iter);
+    return CC_Mqtt5ErrorCode_Success;
+}
+
+ClientImpl::PublishTemplatesList::iterator ClientImpl::findPublishTemplate(const PublishTemplate* tmpl)
+{
+    // Sorted by address to allow lookup of the handle
+    return
+        std::lower_bound(
+            m_publishTemplates.begin(), m_publishTemplates.end(), tmpl,
+            [](auto& ptr, const PublishTemplate* tmplParam)
+            {
+                return std::less<const PublishTemplate*>()(ptr.get(), tmplParam);
+            });
+}
+
+CC_Mqtt5ErrorCode ClientImpl::publishTemplateSend(
+    PublishTemplate* tmpl,
+    const unsigned char* data,
+    unsigned dataLen,
+    const unsigned char* correlationData,
+    unsigned correlationDataLen,
+    CC_Mqtt5PublishCompleteCb cb,
+    void* cbData)
+{
+    // The handle is not dereferenced before it is found, it may be already freed
+    auto iter = findPublishTemplate(tmpl);
+    if ((iter == m_publishTemplates.end()) || (iter->get() != tmpl)) {
+        errorLog("Unknown publish template.");
+        return CC_Mqtt5ErrorCode_BadParam;
+    }
+
+    if ((dataLen > 0U) && (data == nullptr)) {
+        errorLog("Publish data is not provided.");
+        return CC_Mqtt5ErrorCode_BadParam;
+    }
+
+    auto ec = CC_Mqtt5ErrorCode_Success;
+    if (!isPublishAllowed(&ec)) {
+        return ec;
+    }
+
+    auto qos = static_cast<CC_Mqtt5QoS>(tmpl->m_pubMsg.transportField_flags().field_qos().value());
+    auto transientOp = allocTransientSendOp(qos, &tmpl->m_pubMsg);
+    if (transientOp) {
+        ec = transientOp->configTemplate(*tmpl, data, dataLen, correlationData, correlationDataLen);
+        if (ec != CC_Mqtt5ErrorCode_Success) {
+            return ec;
+        }
+
+        return transientOp->sendTransient(cb, cbData);
+    }
+
+    auto* sendOp = allocSendOp(&ec, &tmpl->m_pubMsg);
+    if (sendOp == nullptr) {
+        return ec;
+    }
+
+    ec = sendOp->configTemplate(*tmpl, data, dataLen, correlationData, correlationDataLen);
+    if (ec != CC_Mqtt5ErrorCode_Success) {
+        sendOp->cancel();
+        return ec;
+    }
+
+    return sendOp->send(cb, cbData);
+}
+
+op::ReauthOp* ClientImpl::reauthPrepare(CC_Mqtt5ErrorCode* ec)
+{
+    op::ReauthOp* reauthOp = nullptr;
+    do {
+        if (!m_reauthOps.empty()) {
+            // Already allocated
+            errorLog("Another reauth operation is in progress.");
+            updateEc(ec, CC_Mqtt5ErrorCode_Busy);
+            break;
+        }
+
+        if (!m_sessionState.m_connected) {
+            errorLog("Client must be connected to allow reauth.");
+            updateEc(ec, CC_Mqtt5ErrorCode_NotConnected);
+            break;
+        }
+
+        if (m_sessionState.m_disconnecting) {
+            errorLog("Session disconnection is in progress, cannot initiate reauth.");
+            updateEc(ec, CC_Mqtt5ErrorCode_Disconnecting);
+            break;
+        }
+
+        if (m_clientState.m_networkDisconnected) {
+            errorLog("Network is disconnected.");
+            updateEc(ec, CC_Mqtt5ErrorCode_NetworkDisconnected);
+            break;
+        }
+
+        if (m_sessionState.m_authMethod.empty()) {
+            errorLog("Reauthentication allowed only when CONNECT used authentication.");
+            updateEc(ec, CC_Mqtt5ErrorCode_NotAuthenticated);
+            break;
+        }
+
+        if (m_ops.max_size() <= m_ops.size()) {
+            errorLog("Cannot start reauth operation, retry in next event loop iteration.");
+            updateEc(ec, CC_Mqtt5ErrorCode_RetryLater);
+            break;
+        }
+
+        if (m_preparationLocked) {
+            errorLog("Another operation is being prepared, cannot prepare \"reauth\" without \"send\" or \"cancel\" of the previous.");
+            updateEc(ec, CC_Mqtt5ErrorCode_PreparationLocked);
+            break;
+        }
+
+        auto ptr = m_reauthOpsAlloc.alloc(*this);
+        if (!ptr) {
+            errorLog("Cannot allocate new reauth operation.");
+            updateEc(ec, CC_Mqtt5ErrorCode_OutOfMemory);
+            break;
+        }
+
+        m_preparationLocked = true;
+        addOp(ptr.get());
         m_reauthOps.push_back(std::move(ptr));
         reauthOp = m_reauthOps.back().get();
         updateEc(ec, CC_Mqtt5ErrorCode_Success);
@@ -651,7 +1209,17 @@ bool ClientImpl::pubTopicAliasIsAllocated(const char* topic) const
     }
 }
 
-void ClientImpl::handle(PublishMsg& msg)
+void ClientImpl::handle(ConnackMsg& msg)
+{
+    if (m_sessionState.m_disconnecting) {
+        return;
+    }
+
+    dispatchToOps(msg, m_keepAliveOps);
+    dispatchToOps(msg, m_connectOps);
+}
+
+void ClientImpl::handle(RecvPublishMsg& msg)
 {
     if (m_sessionState.m_disconnecting) {
         return;
@@ -674,29 +1242,28 @@ void ClientImpl::handle(PublishMsg& msg)
                     return;
                 }
 
-                m_ops.push_back(ptr.get());
+                addOp(ptr.get());
                 m_recvOps.push_back(std::move(ptr));
                 msg.dispatch(*m_recvOps.back());
             };
 
         using Qos = op::Op::Qos;
         auto qos = msg.transportField_flags().field_qos().value();
-        if ((qos == Qos::AtMostOnceDelivery) ||
-            (qos == Qos::AtLeastOnceDelivery)) {
+        if (qos == Qos::AtMostOnceDelivery) {
+            // No state is kept for the QoS0 message, handled without registration
+            op::RecvOp recvOp(*this);
+            msg.dispatch(recvOp);
+            break;
+        }
+
+        if (qos == Qos::AtLeastOnceDelivery) {
             createRecvOp();
             break;
         }
 
         if constexpr (Config::MaxQos >= 2) {
-            auto iter =
-                std::find_if(
-                    m_recvOps.begin(), m_recvOps.end(),
-                    [&msg](auto& opPtr)
-                    {
-                        return opPtr->packetId() == msg.field_packetId().field().value();
-                    });
-
-            if (iter == m_recvOps.end()) {
+            auto* deadline = m_recvQos2.lookup(msg.field_packetId().field().value());
+            if (deadline == nullptr) {
                 createRecvOp();
                 break;
             }
@@ -710,8 +1277,9 @@ void ClientImpl::handle(PublishMsg& msg)
                 pubrecMsg.field_reasonCode().field().value() = PubrecMsg::Field_reasonCode::Field::ValueType::PacketIdInUse;
             }
             else {
-                // Duplicate detected, just re-confirming
-                (*iter)->resetTimer();
+                // Duplicate detected, just re-confirming and waiting for PUBREL without timeout
+                *deadline = NoRecvQos2Deadline;
+                programRecvQos2Timer();
             }
 
             sendMessage(pubrecMsg);
@@ -761,16 +1329,8 @@ void ClientImpl::handle(PubrelMsg& msg)
         msg.dispatch(*opPtr);
     }
 
-    auto iter =
-        std::find_if(
-            m_recvOps.begin(), m_recvOps.end(),
-            [&msg](auto& opPtr)
-            {
-                COMMS_ASSERT(opPtr);
-                return opPtr->packetId() == msg.field_packetId().value();
-            });
-
-    if (iter == m_recvOps.end()) {
+    auto packetId = msg.field_packetId().value();
+    if (m_recvQos2.lookup(packetId) == nullptr) {
         errorLog("PUBREL with unknown packet id");
         PubcompMsg pubcompMsg;
         pubcompMsg.field_packetId().setValue(msg.field_packetId().value());
@@ -781,7 +1341,55 @@ void ClientImpl::handle(PubrelMsg& msg)
         return;
     }
 
-    msg.dispatch(**iter);
+    if (!msg.doValid()) {
+        errorLog("Received invalid flags in PUBREL message");
+        op::Op::terminationWithReasonStatic(*this, DisconnectReason::MalformedPacket);
+        return;
+    }
+
+    if (msg.field_properties().doesExist()) {
+        PropsHandler propsHandler;
+        propsHandler.m_lazyUserProps = true; // User properties in PUBREL are ignored
+        for (auto& p : msg.field_properties().field().value()) {
+            p.currentFieldExec(propsHandler);
+        }
+
+        if (propsHandler.m_reasonStr != nullptr) {
+            if (!m_sessionState.m_problemInfoAllowed) {
+                errorLog("Received reason string in PUBREL when \"problem information\" was disabled in CONNECT.");
+                op::Op::terminationWithReasonStatic(*this, DisconnectReason::ProtocolError);
+                return;
+            }
+
+            errorLog("PUBREL reason info:");
+            errorLog(propsHandler.m_reasonStr->field_value().value().c_str());
+        }
+
+        if constexpr (Config::HasUserProps) {
+            if (propsHandler.hasUserProps()) {
+                if (!m_sessionState.m_problemInfoAllowed) {
+                    errorLog("Received user properties in PUBREL when \"problem information\" was disabled in CONNECT.");
+                    op::Op::terminationWithReasonStatic(*this, DisconnectReason::ProtocolError);
+                    return;
+                }
+
+                // User properties in PUBREL are ignored
+            }
+        }
+    }
+
+    m_recvQos2.erase(packetId);
+    programRecvQos2Timer();
+
+    if ((msg.field_reasonCode().doesExist()) &&
+        (msg.field_reasonCode().field().value() != PubrelMsg::Field_reasonCode::Field::ValueType::Success)) {
+        errorLog("Publish reception terminated due to error reason code in PUBREL message.");
+        return;
+    }
+
+    PubcompMsg pubcompMsg;
+    pubcompMsg.field_packetId().setValue(packetId);
+    sendMessage(pubcompMsg);
 }
 
 void ClientImpl::handle(PubcompMsg& msg)
@@ -793,6 +1401,56 @@ void ClientImpl::handle(PubcompMsg& msg)
 
 #endif // #if CC_MQTT5_CLIENT_MAX_QOS >= 2
 
+void ClientImpl::handle(SubackMsg& msg)
+{
+    if (m_sessionState.m_disconnecting) {
+        return;
+    }
+
+    dispatchToOps(msg, m_keepAliveOps);
+    dispatchToOpWithPacketId(msg, m_subscribeOps, msg.field_packetId().value());
+}
+
+void ClientImpl::handle(UnsubackMsg& msg)
+{
+    if (m_sessionState.m_disconnecting) {
+        return;
+    }
+
+    dispatchToOps(msg, m_keepAliveOps);
+    dispatchToOpWithPacketId(msg, m_unsubscribeOps, msg.field_packetId().value());
+}
+
+void ClientImpl::handle(PingrespMsg& msg)
+{
+    if (m_sessionState.m_disconnecting) {
+        return;
+    }
+
+    dispatchToOps(msg, m_keepAliveOps);
+}
+
+void ClientImpl::handle(DisconnectMsg& msg)
+{
+    if (m_sessionState.m_disconnecting) {
+        return;
+    }
+
+    dispatchToOps(msg, m_keepAliveOps);
+    dispatchToOps(msg, m_connectOps);
+}
+
+void ClientImpl::handle(AuthMsg& msg)
+{
+    if (m_sessionState.m_disconnecting) {
+        return;
+    }
+
+    dispatchToOps(msg, m_keepAliveOps);
+    dispatchToOps(msg, m_connectOps);
+    dispatchToOps(msg, m_reauthOps);
+}
+
 void ClientImpl::handle(ProtMessage& msg)
 {
     if (m_sessionState.m_disconnecting) {
@@ -823,67 +1481,157 @@ void ClientImpl::handle(ProtMessage& msg)
     }
 }
 
-CC_Mqtt5ErrorCode ClientImpl::sendMessage(const ProtMessage& msg)
+CC_Mqtt5ErrorCode ClientImpl::sendMessage(const ProtMessage& msg, const std::uint8_t* payload, std::size_t payloadLen)
 {
     auto len = m_frame.length(msg);
-    if ((m_sessionState.m_maxSendPacketSize > 0U) && (m_sessionState.m_maxSendPacketSize < len)) {
-        errorLog("The packet length exceeds limit set by the broker.");
-        return CC_Mqtt5ErrorCode_BadParam;
+    auto ec = checkSendPacketLength(len + payloadLen);
+    if (ec != CC_Mqtt5ErrorCode_Success) {
+        return ec;
+    }
+
+    bool corked = isOutputCorked();
+    if ((!corked) || ((m_buf.max_size() - m_buf.size()) < (len + payloadLen))) {
+        flushOutput();
     }
 
-    if (m_buf.max_size() < len) {
+    if ((!corked) && m_buf.empty() && (m_outputBufReserveCb != nullptr)) {
+        bool written = false;
+        ec = writeToProvidedBuf(msg, len, payload, payloadLen, written);
+        if ((ec != CC_Mqtt5ErrorCode_Success) || written) {
+            return ec;
+        }
+    }
+
+    if ((m_buf.max_size() - m_buf.size()) < len) {
         errorLog("Output buffer overflow.");
         return CC_Mqtt5ErrorCode_BufferOverflow;
     }
 
-    m_buf.resize(len);
-    auto writeIter = comms::writeIteratorFor<ProtMessage>(&m_buf[0]);
+    auto offset = m_buf.size();
+    m_buf.resize(offset + len);
+    auto writeIter = comms::writeIteratorFor<ProtMessage>(&m_buf[offset]);
     auto es = m_frame.write(msg, writeIter, len);
     COMMS_ASSERT(es == comms::ErrorStatus::Success);
     if (es != comms::ErrorStatus::Success) {
         errorLog("Failed to serialize output message.");
+        m_buf.resize(offset);
         return CC_Mqtt5ErrorCode_InternalError;
     }
 
-    COMMS_ASSERT(m_sendOutputDataCb != nullptr);
-    m_sendOutputDataCb(m_sendOutputDataData, &m_buf[0], static_cast<unsigned>(len));
+    if (payloadLen > 0U) {
+        ec = appendPayload(offset, payload, payloadLen);
+        if (ec != CC_Mqtt5ErrorCode_Success) {
+            m_buf.resize(offset);
+            return ec;
+        }
 
-    for (auto& opPtr : m_keepAliveOps) {
-        opPtr->messageSent();
+        if (m_buf.size() == offset) {
+            // Reported directly
+            reportMessageSent();
+            return CC_Mqtt5ErrorCode_Success;
+        }
+    }
+
+    if (!corked) {
+        flushOutput();
     }
 
+    reportMessageSent();
     return CC_Mqtt5ErrorCode_Success;
 }
 
-void ClientImpl::opComplete(const op::Op* op)
+CC_Mqtt5ErrorCode ClientImpl::sendUncorkedMessage(const ProtMessage& msg)
 {
-    auto iter = std::find(m_ops.begin(), m_ops.end(), op);
-    COMMS_ASSERT(iter != m_ops.end());
-    if (iter == m_ops.end()) {
-        return;
+    // The pending output is flushed together with the message
+    auto ec = sendMessage(msg);
+    if ((ec == CC_Mqtt5ErrorCode_Success) && isOutputCorked()) {
+        flushOutput();
     }
 
-    *iter = nullptr;
-    m_opsDeleted = true;
-
-    using ExtraCompleteFunc = void (ClientImpl::*)(const op::Op*);
-    static const ExtraCompleteFunc Map[] = {
-        /* Type_Connect */ &ClientImpl::opComplete_Connect,
-        /* Type_KeepAlive */ &ClientImpl::opComplete_KeepAlive,
-        /* Type_Disconnect */ &ClientImpl::opComplete_Disconnect,
-        /* Type_Subscribe */ &ClientImpl::opComplete_Subscribe,
-        /* Type_Unsubscribe */ &ClientImpl::opComplete_Unsubscribe,
-        /* Type_Recv */ &ClientImpl::opComplete_Recv,
-        /* Type_Send */ &ClientImpl::opComplete_Send,
-        /* Type_Reauth */ &ClientImpl::opComplete_Reauth,
-    };
-    static const std::size_t MapSize = std::extent<decltype(Map)>::value;
-    static_assert(MapSize == op::Op::Type_NumOfValues);
+    return ec;
+}
 
-    auto idx = static_cast<unsigned>(op->type());
-    COMMS_ASSERT(idx < MapSize);
-    if (MapSize <= idx) {
-        return;
+CC_Mqtt5ErrorCode ClientImpl::serializeMessage(const ProtMessage& msg, op::SendOp::EncodedMsgBuf& buf, std::size_t payloadLen)
+{
+    auto len = m_frame.length(msg);
+    if (buf.max_size() < len) {
+        errorLog("Output buffer overflow.");
+        return CC_Mqtt5ErrorCode_BufferOverflow;
+    }
+
+    buf.resize(len);
+    auto writeIter = comms::writeIteratorFor<ProtMessage>(&buf[0]);
+    auto es = m_frame.write(msg, writeIter, len);
+    COMMS_ASSERT(es == comms::ErrorStatus::Success);
+    if (es != comms::ErrorStatus::Success) {
+        errorLog("Failed to serialize output message.");
+        buf.clear();
+        return CC_Mqtt5ErrorCode_InternalError;
+    }
+
+    if (payloadLen == 0U) {
+        return CC_Mqtt5ErrorCode_Success;
+    }
+
+    FixedHeaderBuf header;
+    std::size_t origHeaderLen = 0U;
+    auto headerLen = updateFixedHeader(&buf[0], buf.size(), payloadLen, header, origHeaderLen);
+    if ((headerLen == 0U) || ((buf.max_size() - buf.size()) < (headerLen - origHeaderLen))) {
+        errorLog("The packet is too long.");
+        buf.clear();
+        return CC_Mqtt5ErrorCode_BadParam;
+    }
+
+    buf.erase(buf.begin(), buf.begin() + origHeaderLen);
+    buf.insert(buf.begin(), header.begin(), header.begin() + headerLen);
+    return CC_Mqtt5ErrorCode_Success;
+}
+
+CC_Mqtt5ErrorCode ClientImpl::sendSerialized(const std::uint8_t* buf, std::size_t len, const std::uint8_t* payload, std::size_t payloadLen)
+{
+    CC_Mqtt5DataSegment segments[] = {
+        {buf, static_cast<unsigned>(len)},
+        {payload, static_cast<unsigned>(payloadLen)},
+    };
+
+    unsigned count = 1U;
+    if (payloadLen > 0U) {
+        count = 2U;
+    }
+
+    return sendSegments(segments, count);
+}
+
+void ClientImpl::opComplete(const op::Op* op)
+{
+    auto opsIdx = op->opsIdx();
+    COMMS_ASSERT((opsIdx < m_ops.size()) && (m_ops[opsIdx] == op));
+    if ((m_ops.size() <= opsIdx) || (m_ops[opsIdx] != op)) {
+        return;
+    }
+
+    // The ops list is compacted on the last API exit
+    m_ops[opsIdx] = nullptr;
+    ++m_opsDeletedCount;
+
+    using ExtraCompleteFunc = void (ClientImpl::*)(const op::Op*);
+    static const ExtraCompleteFunc Map[] = {
+        /* Type_Connect */ &ClientImpl::opComplete_Connect,
+        /* Type_KeepAlive */ &ClientImpl::opComplete_KeepAlive,
+        /* Type_Disconnect */ &ClientImpl::opComplete_Disconnect,
+        /* Type_Subscribe */ &ClientImpl::opComplete_Subscribe,
+        /* Type_Unsubscribe */ &ClientImpl::opComplete_Unsubscribe,
+        /* Type_Recv */ &ClientImpl::opComplete_Recv,
+        /* Type_Send */ &ClientImpl::opComplete_Send,
+        /* Type_Reauth */ &ClientImpl::opComplete_Reauth,
+    };
+    static const std::size_t MapSize = std::extent<decltype(Map)>::value;
+    static_assert(MapSize == op::Op::Type_NumOfValues);
+
+    auto idx = static_cast<unsigned>(op->type());
+    COMMS_ASSERT(idx < MapSize);
+    if (MapSize <= idx) {
+        return;
     }
 
     auto func = Map[idx];
@@ -893,34 +1641,47 @@ void ClientImpl::opComplete(const op::Op* op)
 void ClientImpl::brokerConnected(bool sessionPresent)
 {
     m_sessionExpiryTimer.cancel();
+    m_responseTimeouts.setSuspended(false);
 
     m_clientState.m_firstConnect = false;
     m_sessionState.m_connected = true;
 
     do {
         if (sessionPresent) {
-            for (auto& sendOpPtr : m_sendOps) {
-                sendOpPtr->postReconnectionResend();
+            // The completion callbacks may issue new publishes, don't use iterators
+            auto resendCount = m_sendOps.size();
+            for (auto idx = 0U; (idx < resendCount) && (idx < m_sendOps.size()); ++idx) {
+                auto& sendOpPtr = m_sendOps[idx];
+                if (sendOpPtr) {
+                    sendOpPtr->postReconnectionResend();
+                }
             }
 
-            for (auto& recvOpPtr : m_recvOps) {
-                recvOpPtr->postReconnectionResume();
-            }
+            restartRecvQos2Timeouts();
 
+            // Resume the trailing paused ops among the first "high QoS send limit" ones.
             COMMS_ASSERT(0U < m_sessionState.m_highQosSendLimit);
-            auto resumeUntilIdx = std::min(std::size_t(m_sessionState.m_highQosSendLimit), m_sendOps.size());
-            auto resumeFromIdx = resumeUntilIdx;
-            for (auto count = resumeUntilIdx; count > 0U; --count) {
-                auto idx = count - 1U;
+            auto sendOpsCount = m_sendOps.size();
+            auto resumeFromIdx = sendOpsCount;
+            auto liveCount = 0U;
+            for (auto idx = std::size_t(m_sendOpsHead); (idx < sendOpsCount) && (liveCount < m_sessionState.m_highQosSendLimit); ++idx) {
                 auto& sendOpPtr = m_sendOps[idx];
+                if (!sendOpPtr) {
+                    continue;
+                }
+
+                ++liveCount;
                 if (!sendOpPtr->isPaused()) {
-                    break;
+                    resumeFromIdx = sendOpsCount;
+                    continue;
                 }
 
-                resumeFromIdx = idx;
+                if (sendOpsCount <= resumeFromIdx) {
+                    resumeFromIdx = idx;
+                }
             }
 
-            if (resumeFromIdx < resumeUntilIdx) {
+            if (resumeFromIdx < sendOpsCount) {
                 resumeSendOpsSince(static_cast<unsigned>(resumeFromIdx));
             }
             break;
@@ -928,6 +1689,10 @@ void ClientImpl::brokerConnected(bool sessionPresent)
 
         // Old stored session, terminate pending ops
         for (auto* op : m_ops) {
+            if (op == nullptr) {
+                continue;
+            }
+
             auto opType = op->type();
             if ((opType != op::Op::Type::Type_Send) &&
                 (opType != op::Op::Type::Type_Recv)) {
@@ -936,6 +1701,8 @@ void ClientImpl::brokerConnected(bool sessionPresent)
 
             op->terminateOp(CC_Mqtt5AsyncOpStatus_Aborted);
         }
+
+        clearRecvQos2();
     } while (false);
 
     m_clientState.m_sendTopicAliases.clear();
@@ -951,10 +1718,14 @@ void ClientImpl::brokerDisconnected(
     COMMS_ASSERT((reason == CC_Mqtt5BrokerDisconnectReason_DisconnectMsg) || (info == nullptr));
     m_clientState.m_initialized = false; // Require re-initialization
     m_sessionState.m_connected = false;
+    m_responseTimeouts.setSuspended(true); // Nothing times out while disconnected, resumed on reconnection
+    m_pendingFrameLen = 0U;
+    reportMsgsBatch(); // Messages received before the disconnection, not acknowledged
+    m_inputBuf.clear();
 
     bool preserveSendRecv =
         (m_sessionState.m_sessionExpiryIntervalMs > 0U) &&
-        ((!m_recvOps.empty()) || (!m_sendOps.empty()));
+        ((recvsCount() > 0U) || (sendsCount() > 0U));
 
     auto termMode = TerminateMode_AbortSendRecvOps;
     if (preserveSendRecv) {
@@ -971,12 +1742,18 @@ void ClientImpl::brokerDisconnected(
             }
         }
 
+        m_recvQos2Timer.cancel(); // Restarted on reconnection
+
         const auto NeverExpires = (static_cast<decltype(m_sessionState.m_sessionExpiryIntervalMs)>(CC_MQTT5_SESSION_NEVER_EXPIRES) * 1000U);
         if (m_sessionState.m_sessionExpiryIntervalMs != NeverExpires) {
             m_sessionExpiryTimer.wait(m_sessionState.m_sessionExpiryIntervalMs, &ClientImpl::sessionExpiryTimeoutCb, this);
         }
     }
 
+    // The application is expected to close the connection upon the report,
+    // make sure the pending output (such as DISCONNECT) is delivered beforehand.
+    flushOutput();
+
     if (reason < CC_Mqtt5BrokerDisconnectReason_ValuesLimit) {
         COMMS_ASSERT(m_brokerDisconnectReportCb != nullptr);
         m_brokerDisconnectReportCb(m_brokerDisconnectReportData, reason, info);
@@ -989,46 +1766,78 @@ void ClientImpl::reportMsgInfo(const CC_Mqtt5MessageInfo& info)
     m_messageReceivedReportCb(m_messageReceivedReportData, &info);
 }
 
-bool ClientImpl::hasPausedSendsBefore(const op::SendOp* sendOp) const
+void ClientImpl::batchMsgInfo(
+    const CC_Mqtt5MessageInfo& info,
+    op::Op::UserPropsList& userProps,
+    const op::Op::LazyUserProps& lazyUserProps,
+    op::Op::SubIdsStorage& subIds,
+    const TopicStr* aliasTopic,
+    unsigned packetId)
 {
-    auto riter =
-        std::find_if(
-            m_sendOps.rbegin(), m_sendOps.rend(),
-            [sendOp](auto& opPtr)
-            {
-                return opPtr.get() == sendOp;
-            });
+    if constexpr (ExtConfig::HasMsgsBatch) {
+        m_batchedMsgs.resize(m_batchedMsgs.size() + 1U);
+        auto& batchedMsg = m_batchedMsgs.back();
+        batchedMsg.m_info = info;
+        batchedMsg.m_userProps = std::move(userProps);
+        batchedMsg.m_lazyUserProps = lazyUserProps; // Storage pointer is updated when reported
+        batchedMsg.m_subIds = std::move(subIds);
+        batchedMsg.m_packetId = packetId;
 
-    COMMS_ASSERT(riter != m_sendOps.rend());
-    if (riter == m_sendOps.rend()) {
-        return false;
-    }
+        if (info.m_qos == CC_Mqtt5QoS_AtLeastOnceDelivery) {
+            // The QoS2 ones are recorded as pending PUBREL
+            ++m_batchedQos1Count;
+        }
 
-    auto iter = riter.base() - 1;
-    auto idx = static_cast<unsigned>(std::distance(m_sendOps.begin(), iter));
-    COMMS_ASSERT(idx < m_sendOps.size());
-    if (idx == 0U) {
-        return false;
+        if (aliasTopic != nullptr) {
+            // The aliased topic can be updated by the following messages
+            batchedMsg.m_aliasTopic = *aliasTopic;
+        }
     }
+    else {
+        [[maybe_unused]] static constexpr bool ShouldNotBeCalled = false;
+        COMMS_ASSERT(ShouldNotBeCalled);
+        static_cast<void>(info);
+        static_cast<void>(userProps);
+        static_cast<void>(lazyUserProps);
+        static_cast<void>(subIds);
+        static_cast<void>(aliasTopic);
+        static_cast<void>(packetId);
+    }
+}
+
+bool ClientImpl::hasPausedSendsBefore(const op::SendOp* sendOp) const
+{
+    auto idx = sendOp->sendOpsIdx();
+    COMMS_ASSERT((idx < m_sendOps.size()) && (m_sendOps[idx].get() == sendOp));
+    auto pausedIdx =
+        advanceSendOpsHint(
+            SendOpsHint_Paused, idx,
+            [](const op::SendOp& op)
+            {
+                return op.isPaused();
+            });
 
-    auto& prevSendOpPtr = m_sendOps[idx - 1U];
-    return prevSendOpPtr->isPaused();
+    return pausedIdx < idx;
 }
 
 bool ClientImpl::hasHigherQosSendsBefore(const op::SendOp* sendOp, op::Op::Qos qos) const
 {
-    for (auto& sendOpPtr : m_sendOps) {
-        if (sendOpPtr.get() == sendOp) {
-            return false;
-        }
-
-        if (sendOpPtr->qos() > qos) {
-            return true;
-        }
+    if (op::Op::Qos::ExactlyOnceDelivery <= qos) {
+        return false;
     }
 
-    COMMS_ASSERT(false); // Mustn't reach here
-    return false;
+    auto idx = sendOp->sendOpsIdx();
+    COMMS_ASSERT((idx < m_sendOps.size()) && (m_sendOps[idx].get() == sendOp));
+    auto hint = (qos == op::Op::Qos::AtMostOnceDelivery) ? SendOpsHint_HigherThanQos0 : SendOpsHint_HigherThanQos1;
+    auto higherQosIdx =
+        advanceSendOpsHint(
+            hint, idx,
+            [qos](const op::SendOp& op)
+            {
+                return qos < op.qos();
+            });
+
+    return higherQosIdx < idx;
 }
 
 void ClientImpl::allowNextPrepare()
@@ -1061,7 +1870,13 @@ void ClientImpl::doApiExit()
         return;
     }
 
-    cleanOps();
+    if (!m_outputCorked) {
+        flushOutput();
+    }
+
+    if ((m_opsDeletedCount > 0U) || (m_sendOpsDeletedCount > 0U)) {
+        cleanOps();
+    }
 
     if (m_nextTickProgramCb == nullptr) {
         return;
@@ -1075,6 +1890,215 @@ void ClientImpl::doApiExit()
     m_nextTickProgramCb(m_nextTickProgramData, nextWait);
 }
 
+bool ClientImpl::isOutputCorked() const
+{
+    return m_outputCorked || m_outputBatched || (m_configState.m_autoCork && (m_apiEnterCount > 0U));
+}
+
+CC_Mqtt5ErrorCode ClientImpl::checkSendPacketLength(std::size_t len)
+{
+    if ((m_sessionState.m_maxSendPacketSize > 0U) && (m_sessionState.m_maxSendPacketSize < len)) {
+        errorLog("The packet length exceeds limit set by the broker.");
+        return CC_Mqtt5ErrorCode_BadParam;
+    }
+
+    return CC_Mqtt5ErrorCode_Success;
+}
+
+CC_Mqtt5ErrorCode ClientImpl::sendSegments(const CC_Mqtt5DataSegment* segments, unsigned count)
+{
+    std::size_t len = 0U;
+    for (auto idx = 0U; idx < count; ++idx) {
+        if ((std::numeric_limits<unsigned>::max() - len) < segments[idx].m_dataLen) {
+            errorLog("Total length of the output data segments is too big.");
+            return CC_Mqtt5ErrorCode_BufferOverflow;
+        }
+
+        len += segments[idx].m_dataLen;
+    }
+
+    auto ec = checkSendPacketLength(len);
+    if (ec != CC_Mqtt5ErrorCode_Success) {
+        return ec;
+    }
+
+    bool corked = isOutputCorked();
+    if ((!corked) && m_buf.empty()) {
+        // Nothing is pending, no need to copy into the internal buffer
+        if (m_outputBufReserveCb != nullptr) {
+            auto* ptr = m_outputBufReserveCb(m_outputBufProviderData, static_cast<unsigned>(len));
+            if (ptr != nullptr) {
+                for (auto idx = 0U; idx < count; ++idx) {
+                    ptr = std::copy_n(segments[idx].m_data, segments[idx].m_dataLen, ptr);
+                }
+
+                m_outputBufCommitCb(m_outputBufProviderData, static_cast<unsigned>(len));
+                reportMessageSent();
+                return CC_Mqtt5ErrorCode_Success;
+            }
+        }
+
+        if (m_sendOutputDataVCb != nullptr) {
+            m_sendOutputDataVCb(m_sendOutputDataVData, segments, count);
+            reportMessageSent();
+            return CC_Mqtt5ErrorCode_Success;
+        }
+
+        if (count == 1U) {
+            reportOutput(segments[0].m_data, segments[0].m_dataLen);
+            reportMessageSent();
+            return CC_Mqtt5ErrorCode_Success;
+        }
+    }
+
+    if ((m_buf.max_size() - m_buf.size()) < len) {
+        flushOutput();
+    }
+
+    if ((m_buf.max_size() - m_buf.size()) < len) {
+        errorLog("Output buffer overflow.");
+        return CC_Mqtt5ErrorCode_BufferOverflow;
+    }
+
+    for (auto idx = 0U; idx < count; ++idx) {
+        auto& seg = segments[idx];
+        m_buf.insert(m_buf.end(), seg.m_data, seg.m_data + seg.m_dataLen);
+    }
+
+    if (!corked) {
+        flushOutput();
+    }
+
+    reportMessageSent();
+    return CC_Mqtt5ErrorCode_Success;
+}
+
+CC_Mqtt5ErrorCode ClientImpl::writeToProvidedBuf(const ProtMessage& msg, std::size_t len, const std::uint8_t* payload, std::size_t payloadLen, bool& written)
+{
+    COMMS_ASSERT(m_outputBufReserveCb != nullptr);
+    COMMS_ASSERT(m_outputBufCommitCb != nullptr);
+    auto growth = fixedHeaderGrowth(len, payloadLen);
+    auto total = len + growth + payloadLen;
+    auto* ptr = m_outputBufReserveCb(m_outputBufProviderData, static_cast<unsigned>(total));
+    if (ptr == nullptr) {
+        // Use the internal buffer instead
+        return CC_Mqtt5ErrorCode_Success;
+    }
+
+    // When the payload is reported separately, the fixed header needs to be
+    // re-encoded, reserve space for its growth in front of the message.
+    auto writeIter = comms::writeIteratorFor<ProtMessage>(ptr + growth);
+    auto es = m_frame.write(msg, writeIter, len);
+    COMMS_ASSERT(es == comms::ErrorStatus::Success);
+    if (es != comms::ErrorStatus::Success) {
+        errorLog("Failed to serialize output message.");
+        m_outputBufCommitCb(m_outputBufProviderData, 0U);
+        return CC_Mqtt5ErrorCode_InternalError;
+    }
+
+    if (payloadLen > 0U) {
+        FixedHeaderBuf header;
+        std::size_t origHeaderLen = 0U;
+        auto headerLen = updateFixedHeader(ptr + growth, len, payloadLen, header, origHeaderLen);
+        if (headerLen == 0U) {
+            errorLog("The packet is too long.");
+            m_outputBufCommitCb(m_outputBufProviderData, 0U);
+            return CC_Mqtt5ErrorCode_BadParam;
+        }
+
+        COMMS_ASSERT(headerLen == (origHeaderLen + growth));
+        std::copy_n(header.begin(), headerLen, ptr);
+        std::copy_n(payload, payloadLen, ptr + growth + len);
+    }
+
+    m_outputBufCommitCb(m_outputBufProviderData, static_cast<unsigned>(total));
+    written = true;
+    reportMessageSent();
+    return CC_Mqtt5ErrorCode_Success;
+}
+
+CC_Mqtt5ErrorCode ClientImpl::appendPayload(std::size_t offset, const std::uint8_t* payload, std::size_t payloadLen)
+{
+    COMMS_ASSERT(offset < m_buf.size());
+    FixedHeaderBuf header;
+    std::size_t origHeaderLen = 0U;
+    auto headerLen = updateFixedHeader(&m_buf[offset], m_buf.size() - offset, payloadLen, header, origHeaderLen);
+    if (headerLen == 0U) {
+        errorLog("The packet is too long.");
+        return CC_Mqtt5ErrorCode_BadParam;
+    }
+
+    if ((offset == 0U) && (m_sendOutputDataVCb != nullptr) && (!isOutputCorked())) {
+        // Nothing is pending, report the payload as a separate segment without copying
+        CC_Mqtt5DataSegment segments[] = {
+            {header.data(), static_cast<unsigned>(headerLen)},
+            {&m_buf[origHeaderLen], static_cast<unsigned>(m_buf.size() - origHeaderLen)},
+            {payload, static_cast<unsigned>(payloadLen)},
+        };
+
+        m_sendOutputDataVCb(m_sendOutputDataVData, segments, 3U);
+        m_buf.clear();
+        return CC_Mqtt5ErrorCode_Success;
+    }
+
+    if ((m_buf.max_size() - m_buf.size()) < ((headerLen - origHeaderLen) + payloadLen)) {
+        errorLog("Output buffer overflow.");
+        return CC_Mqtt5ErrorCode_BufferOverflow;
+    }
+
+    m_buf.erase(m_buf.begin() + offset, m_buf.begin() + offset + origHeaderLen);
+    m_buf.insert(m_buf.begin() + offset, header.begin(), header.begin() + headerLen);
+    m_buf.insert(m_buf.end(), payload, payload + payloadLen);
+    return CC_Mqtt5ErrorCode_Success;
+}
+
+void ClientImpl::reportOutput(const std::uint8_t* buf, std::size_t len)
+{
+    if (m_sendOutputDataVCb != nullptr) {
+        CC_Mqtt5DataSegment segment = {buf, static_cast<unsigned>(len)};
+        m_sendOutputDataVCb(m_sendOutputDataVData, &segment, 1U);
+        return;
+    }
+
+    COMMS_ASSERT(m_sendOutputDataCb != nullptr);
+    m_sendOutputDataCb(m_sendOutputDataData, buf, static_cast<unsigned>(len));
+}
+
+void ClientImpl::reportMessageSent()
+{
+    for (auto& opPtr : m_keepAliveOps) {
+        opPtr->messageSent();
+    }
+}
+
+void ClientImpl::flushOutput()
+{
+    if (m_flushingOutput) {
+        // Reentrant invocation from within the send callback,
+        // the appended data is going to be flushed by the loop below.
+        return;
+    }
+
+    m_flushingOutput = true;
+    auto flushingGuard =
+        comms::util::makeScopeGuard(
+            [this]()
+            {
+                m_flushingOutput = false;
+            });
+
+    while (!m_buf.empty()) {
+        auto len = m_buf.size();
+        reportOutput(&m_buf[0], len);
+        if (m_buf.size() < len) {
+            // Cleared due to network disconnection reported from within the callback
+            break;
+        }
+
+        m_buf.erase(m_buf.begin(), m_buf.begin() + len);
+    }
+}
+
 void ClientImpl::createKeepAliveOpIfNeeded()
 {
     if (!m_keepAliveOps.empty()) {
@@ -1083,11 +2107,12 @@ void ClientImpl::createKeepAliveOpIfNeeded()
 
     auto ptr = m_keepAliveOpsAlloc.alloc(*this);
     if (!ptr) {
-        COMMS_ASSERT(false); // Should not happen
+        [[maybe_unused]] static constexpr bool ShouldNotHappen = false;
+        COMMS_ASSERT(ShouldNotHappen);
         return;
     }
 
-    m_ops.push_back(ptr.get());
+    addOp(ptr.get());
     m_keepAliveOps.push_back(std::move(ptr));
 }
 
@@ -1108,24 +2133,107 @@ void ClientImpl::terminateOps(CC_Mqtt5AsyncOpStatus status, TerminateMode mode)
 
         op->terminateOp(status);
     }
+
+    if (mode != TerminateMode_KeepSendRecvOps) {
+        clearRecvQos2();
+    }
+}
+
+void ClientImpl::addOp(op::Op* op)
+{
+    op->setOpsIdx(static_cast<unsigned>(m_ops.size()));
+    m_ops.push_back(op);
+}
+
+void ClientImpl::cleanOps(bool force)
+{
+    // The bounded (bare metal) lists are compacted on every API exit to
+    // preserve their full capacity, the dynamic ones only when the
+    // number of holes becomes significant to keep the removal amortized O(1).
+    auto needsCompaction =
+        [force](std::size_t deletedCount, std::size_t size, std::size_t maxSize, bool bounded)
+        {
+            return
+                (deletedCount > 0U) &&
+                (force || bounded || ((deletedCount * 2U) >= size) || (maxSize <= size));
+        };
+
+    if (needsCompaction(m_opsDeletedCount, m_ops.size(), m_ops.max_size(), ExtConfig::OpsLimit > 0U)) {
+        auto writeIdx = 0U;
+        for (auto* op : m_ops) {
+            if (op == nullptr) {
+                continue;
+            }
+
+            op->setOpsIdx(writeIdx);
+            m_ops[writeIdx] = op;
+            ++writeIdx;
+        }
+
+        m_ops.resize(writeIdx);
+        m_opsDeletedCount = 0U;
+    }
+
+    if (needsCompaction(m_sendOpsDeletedCount, m_sendOps.size(), m_sendOps.max_size(), ExtConfig::SendOpsListLimit > 0U)) {
+        static constexpr auto NoHint = std::numeric_limits<unsigned>::max();
+        auto oldHints = m_sendOpsHints;
+        m_sendOpsHints.fill(NoHint);
+
+        auto writeIdx = 0U;
+        for (auto readIdx = 0U; readIdx < m_sendOps.size(); ++readIdx) {
+            auto& sendOpPtr = m_sendOps[readIdx];
+            if (!sendOpPtr) {
+                continue;
+            }
+
+            // Hints point to the first remaining op at or after their old position
+            for (auto hintIdx = 0U; hintIdx < m_sendOpsHints.size(); ++hintIdx) {
+                if ((m_sendOpsHints[hintIdx] == NoHint) && (oldHints[hintIdx] <= readIdx)) {
+                    m_sendOpsHints[hintIdx] = writeIdx;
+                }
+            }
+
+            sendOpPtr->setSendOpsIdx(writeIdx);
+            if (&m_sendOps[writeIdx] != &sendOpPtr) {
+                m_sendOps[writeIdx] = std::move(sendOpPtr);
+            }
+            ++writeIdx;
+        }
+
+        while (writeIdx < m_sendOps.size()) {
+            m_sendOps.pop_back();
+        }
+
+        for (auto& hintIdx : m_sendOpsHints) {
+            hintIdx = std::min(hintIdx, writeIdx);
+        }
+
+        m_sendOpsHead = 0U;
+        m_sendOpsDeletedCount = 0U;
+    }
 }
 
-void ClientImpl::cleanOps()
+void ClientImpl::reclaimSendOpsSlots()
 {
-    if (!m_opsDeleted) {
+    if (m_apiEnterCount == 0U) {
+        // Not invoked from within a callback, the completed operations can be removed
+        cleanOps(true);
         return;
     }
 
-    m_ops.erase(
-        std::remove_if(
-            m_ops.begin(), m_ops.end(),
-            [](auto* op)
-            {
-                return op == nullptr;
-            }),
-        m_ops.end());
+    // The list may be iterated by index in the caller's context, don't move
+    // the remaining ops, only reuse the trailing slots of the completed ones.
+    while ((!m_sendOps.empty()) && (!m_sendOps.back())) {
+        COMMS_ASSERT(0U < m_sendOpsDeletedCount);
+        m_sendOps.pop_back();
+        --m_sendOpsDeletedCount;
+    }
 
-    m_opsDeleted = false;
+    auto sendOpsCount = static_cast<unsigned>(m_sendOps.size());
+    m_sendOpsHead = std::min(m_sendOpsHead, sendOpsCount);
+    for (auto& hintIdx : m_sendOpsHints) {
+        hintIdx = std::min(hintIdx, sendOpsCount);
+    }
 }
 
 void ClientImpl::errorLogInternal(const char* msg)
@@ -1151,9 +2259,9 @@ void ClientImpl::sendDisconnectMsg(DisconnectMsg::Field_reasonCode::Field::Value
 CC_Mqtt5ErrorCode ClientImpl::initInternal()
 {
     auto guard = apiEnter();
-    if ((m_sendOutputDataCb == nullptr) ||
+    if (((m_sendOutputDataCb == nullptr) && (m_sendOutputDataVCb == nullptr)) ||
         (m_brokerDisconnectReportCb == nullptr) ||
-        (m_messageReceivedReportCb == nullptr)) {
+        ((m_messageReceivedReportCb == nullptr) && (!isMsgsBatchEnabled()))) {
         errorLog("Hasn't set all must have callbacks");
         return CC_Mqtt5ErrorCode_NotIntitialized;
     }
@@ -1183,7 +2291,7 @@ void ClientImpl::resumeSendOpsSince(unsigned idx)
 {
     while (idx < m_sendOps.size()) {
         auto& opToResumePtr = m_sendOps[idx];
-        if (!opToResumePtr->isPaused()) {
+        if ((!opToResumePtr) || (!opToResumePtr->isPaused())) {
             ++idx;
             continue;
         }
@@ -1196,6 +2304,123 @@ void ClientImpl::resumeSendOpsSince(unsigned idx)
     }
 }
 
+bool ClientImpl::addPendingRecvQos2(std::uint16_t packetId)
+{
+    if (m_recvQos2Timeouts.max_size() <= m_recvQos2Timeouts.size()) {
+        compactRecvQos2Timeouts();
+    }
+
+    if (m_recvQos2Timeouts.max_size() <= m_recvQos2Timeouts.size()) {
+        return false;
+    }
+
+    auto deadline = m_timerMgr.elapsedMs() + m_configState.m_responseTimeoutMs;
+    if (!m_recvQos2.insert(packetId, deadline)) {
+        return false;
+    }
+
+    // The response timeout is the same for all the receptions, the records are
+    // appended in the order of their deadlines.
+    m_recvQos2Timeouts.push_back(RecvQos2Timeout{deadline, packetId});
+    if (!m_recvQos2Timer.isActive()) {
+        programRecvQos2Timer();
+    }
+
+    return true;
+}
+
+void ClientImpl::restartRecvQos2Timeouts()
+{
+    auto deadline = m_timerMgr.elapsedMs() + m_configState.m_responseTimeoutMs;
+    m_recvQos2Timeouts.clear();
+    m_recvQos2TimeoutsHead = 0U;
+    m_recvQos2.forEach(
+        [this, deadline](std::uint16_t packetId, std::uint64_t& entryDeadline)
+        {
+            entryDeadline = deadline;
+            m_recvQos2Timeouts.push_back(RecvQos2Timeout{deadline, packetId});
+        });
+
+    programRecvQos2Timer();
+}
+
+bool ClientImpl::isRecvQos2TimeoutValid(const RecvQos2Timeout& timeout)
+{
+    // The reception can be already complete or its timeout restarted / cancelled
+    auto* deadline = m_recvQos2.lookup(timeout.m_packetId);
+    return (deadline != nullptr) && (*deadline == timeout.m_deadline);
+}
+
+void ClientImpl::compactRecvQos2Timeouts()
+{
+    auto writeIdx = 0U;
+    for (auto readIdx = m_recvQos2TimeoutsHead; readIdx < m_recvQos2Timeouts.size(); ++readIdx) {
+        if (!isRecvQos2TimeoutValid(m_recvQos2Timeouts[readIdx])) {
+            continue;
+        }
+
+        m_recvQos2Timeouts[writeIdx] = m_recvQos2Timeouts[readIdx];
+        ++writeIdx;
+    }
+
+    m_recvQos2Timeouts.resize(writeIdx);
+    m_recvQos2TimeoutsHead = 0U;
+}
+
+void ClientImpl::programRecvQos2Timer()
+{
+    while ((m_recvQos2TimeoutsHead < m_recvQos2Timeouts.size()) &&
+           (!isRecvQos2TimeoutValid(m_recvQos2Timeouts[m_recvQos2TimeoutsHead]))) {
+        ++m_recvQos2TimeoutsHead;
+    }
+
+    if (m_recvQos2Timeouts.size() <= m_recvQos2TimeoutsHead) {
+        m_recvQos2Timeouts.clear();
+        m_recvQos2TimeoutsHead = 0U;
+        m_recvQos2Timer.cancel();
+        return;
+    }
+
+    if ((m_recvQos2Timeouts.size() / 2U) <= m_recvQos2TimeoutsHead) {
+        compactRecvQos2Timeouts();
+    }
+
+    auto deadline = m_recvQos2Timeouts[m_recvQos2TimeoutsHead].m_deadline;
+    auto now = m_timerMgr.elapsedMs();
+    auto waitMs = (now < deadline) ? (deadline - now) : 0U;
+    m_recvQos2Timer.wait(waitMs, &ClientImpl::recvQos2TimeoutCb, this);
+}
+
+void ClientImpl::recvQos2TimeoutInternal()
+{
+    // When there is no PUBREL from broker, just terminate the reception.
+    // The retry will be initiated by the broker.
+    auto now = m_timerMgr.elapsedMs();
+    while (m_recvQos2TimeoutsHead < m_recvQos2Timeouts.size()) {
+        auto& timeout = m_recvQos2Timeouts[m_recvQos2TimeoutsHead];
+        if (now < timeout.m_deadline) {
+            break;
+        }
+
+        if (isRecvQos2TimeoutValid(timeout)) {
+            errorLog("Timeout on PUBREL reception from broker.");
+            m_recvQos2.erase(timeout.m_packetId);
+        }
+
+        ++m_recvQos2TimeoutsHead;
+    }
+
+    programRecvQos2Timer();
+}
+
+void ClientImpl::clearRecvQos2()
+{
+    m_recvQos2.clear();
+    m_recvQos2Timeouts.clear();
+    m_recvQos2TimeoutsHead = 0U;
+    m_recvQos2Timer.cancel();
+}
+
 void ClientImpl::sessionExpiryTimeoutInternal()
 {
     COMMS_ASSERT(m_apiEnterCount > 0U);
@@ -1213,23 +2438,32 @@ void ClientImpl::sessionExpiryTimeoutInternal()
 
         op->terminateOp(CC_Mqtt5AsyncOpStatus_BrokerDisconnected);
     }
+
+    clearRecvQos2();
 }
 
 op::SendOp* ClientImpl::findSendOp(std::uint16_t packetId)
 {
-    auto iter =
-        std::find_if(
-            m_sendOps.begin(), m_sendOps.end(),
-            [packetId](auto& opPtr)
-            {
-                return opPtr->packetId() == packetId;
-            });
+    return m_sendOpsPacketIds.find(packetId);
+}
 
-    if (iter == m_sendOps.end()) {
-        return nullptr;
+template <typename TFunc>
+unsigned ClientImpl::advanceSendOpsHint(SendOpsHint hint, unsigned untilIdx, TFunc&& func) const
+{
+    // The hints only move forward: the skipped ops never start matching the
+    // condition again and the new ops are always appended at the end.
+    auto& hintIdx = m_sendOpsHints[hint];
+    hintIdx = std::max(hintIdx, m_sendOpsHead);
+    while (hintIdx < untilIdx) {
+        auto& sendOpPtr = m_sendOps[hintIdx];
+        if (sendOpPtr && func(*sendOpPtr)) {
+            break;
+        }
+
+        ++hintIdx;
     }
 
-    return iter->get();
+    return hintIdx;
 }
 
 bool ClientImpl::isLegitSendAck(const op::SendOp* sendOp, bool pubcompAck) const
@@ -1238,48 +2472,52 @@ bool ClientImpl::isLegitSendAck(const op::SendOp* sendOp, bool pubcompAck) const
         return false;
     }
 
-    for (auto& sendOpPtr : m_sendOps) {
-        if (sendOpPtr.get() == sendOp) {
-            return true;
-        }
-
-        if (!sendOpPtr->isAcked()) {
-            return false;
-        }
-
-        if (pubcompAck && (sendOp != m_sendOps.front().get())) {
-            return false;
-        }
+    auto idx = sendOp->sendOpsIdx();
+    COMMS_ASSERT((idx < m_sendOps.size()) && (m_sendOps[idx].get() == sendOp));
+    if (pubcompAck) {
+        // Only the first op is allowed to receive PUBCOMP
+        return idx == m_sendOpsHead;
     }
 
-    COMMS_ASSERT(false); // Should not be reached;
-    return false;
+    // The acks are accepted only in order, all the acked ops precede the unacked ones.
+    auto unackedIdx =
+        advanceSendOpsHint(
+            SendOpsHint_Unacked, idx,
+            [](const op::SendOp& op)
+            {
+                return !op.isAcked();
+            });
+
+    return idx <= unackedIdx;
 }
 
 void ClientImpl::resendAllUntil(op::SendOp* sendOp)
 {
     // Do index controlled iteration because forcing dup resend can
-    // cause early message destruction.
-    for (auto idx = 0U; idx < m_sendOps.size();) {
+    // cause early message destruction, the destructed op leaves a hole
+    // in the list until the API exit.
+    for (auto idx = m_sendOpsHead; idx < m_sendOps.size(); ++idx) {
         auto& sendOpPtr = m_sendOps[idx];
-        COMMS_ASSERT(sendOpPtr);
+        if (!sendOpPtr) {
+            continue;
+        }
+
         auto* opBeforeResend = sendOpPtr.get();
         sendOpPtr->forceDupResend(); // can destruct object
         if (opBeforeResend == sendOp) {
             break;
         }
-
-        auto* opAfterResend = sendOpPtr.get();
-        if (opBeforeResend != opAfterResend) {
-            // The op object was destructed and erased,
-            // do not increment index;
-            continue;
-        }
-
-        ++idx;
     }
 }
 
+void ClientImpl::registerSendOpPacketId(op::SendOp& sendOp)
+{
+    auto packetId = static_cast<std::uint16_t>(sendOp.packetId());
+    COMMS_ASSERT(packetId != 0U);
+    [[maybe_unused]] auto inserted = m_sendOpsPacketIds.insert(packetId, &sendOp);
+    COMMS_ASSERT(inserted);
+}
+
 bool ClientImpl::processPublishAckMsg(ProtMessage& msg, std::uint16_t packetId, bool pubcompAck)
 {
     for (auto& opPtr : m_keepAliveOps) {
@@ -1300,6 +2538,270 @@ bool ClientImpl::processPublishAckMsg(ProtMessage& msg, std::uint16_t packetId,
     return true;
 }
 
+bool ClientImpl::processFrames(const std::uint8_t* iter, unsigned len, unsigned& consumed, DisconnectReason& reason)
+{
+    consumed = 0U;
+    while (consumed < len) {
+        auto remLen = len - consumed;
+
+        if (remLen < m_pendingFrameLen) {
+            // The fixed header of the pending frame has already been decoded,
+            // no need to do it again until the whole frame is available.
+            break;
+        }
+
+        using IdAndFlagsField = ProtFrame::Layer_idAndFlags::Field;
+        static_assert(IdAndFlagsField::minLength() == IdAndFlagsField::maxLength());
+
+        if (remLen <= IdAndFlagsField::minLength()) {
+            // Size info is not available
+            break;
+        }
+
+        auto* frame = &m_frame;
+        if constexpr (ExtConfig::InPlaceMsgsBatchLimit > 0U) {
+            if (isMsgsBatchEnabled()) {
+                if (m_batchFrames.size() <= m_batchedMsgs.size()) {
+                    // All the in-place storages are occupied by the batched messages
+                    reportMsgsBatch();
+                }
+
+                if (m_batchFrames.size() <= m_batchedMsgs.size()) {
+                    errorLog("Processing of the incoming data from within the callback is not supported.");
+                    return false;
+                }
+
+                frame = &m_batchFrames[m_batchedMsgs.size()];
+            }
+        }
+
+        auto* iterTmp = iter;
+        std::size_t missingSize = 0U;
+        ProtFrame::MsgPtr msg;
+        auto es = frame->read(msg, iterTmp, remLen, comms::frame::missingSize(missingSize));
+        if (es == comms::ErrorStatus::NotEnoughData) {
+            m_pendingFrameLen = remLen + static_cast<unsigned>(missingSize);
+            if (!isRecvFrameLenAllowed(m_pendingFrameLen)) {
+                reason = DisconnectReason::PacketTooLarge;
+                return false;
+            }
+
+            break;
+        }
+
+        if constexpr (Config::HasInPlaceMsgAlloc) {
+            if (es == comms::ErrorStatus::MsgAllocFailure) {
+                // Single in-place message storage is still occupied by the message being handled
+                errorLog("Processing of the incoming data from within the callback is not supported.");
+                return false;
+            }
+        }
+
+        if (es != comms::ErrorStatus::Success) {
+            errorLog("Unexpected error in framing / payload parsing");
+            return false;
+        }
+
+        auto frameLen = static_cast<unsigned>(std::distance(iter, iterTmp));
+        if (!isRecvFrameLenAllowed(frameLen)) {
+            reason = DisconnectReason::PacketTooLarge;
+            return false;
+        }
+
+        m_pendingFrameLen = 0U;
+        COMMS_ASSERT(msg);
+        msg->dispatch(*this);
+
+        if constexpr (ExtConfig::HasMsgsBatch) {
+            if ((!m_batchedMsgs.empty()) && (!m_batchedMsgs.back().m_msg)) {
+                // The batched message info references the decoded data
+                m_batchedMsgs.back().m_msg = std::move(msg);
+            }
+        }
+        consumed += frameLen;
+        iter = iterTmp;
+    }
+
+    return true;
+}
+
+bool ClientImpl::completeStoredFrame(const std::uint8_t*& iter, unsigned& len, DisconnectReason& reason)
+{
+    // Copy only the bytes belonging to the stored packet
+    while ((!m_inputBuf.empty()) && (len > 0U)) {
+        std::size_t required = 1U;
+        if (m_inputBuf.size() < m_pendingFrameLen) {
+            required = m_pendingFrameLen - m_inputBuf.size();
+        }
+
+        auto count = static_cast<unsigned>(std::min(required, std::size_t(len)));
+        if (m_inputBuf.max_size() < (m_inputBuf.size() + count)) {
+            errorLog("The incoming packet exceeds the input buffer capacity");
+            reason = DisconnectReason::PacketTooLarge;
+            return false;
+        }
+
+        m_inputBuf.insert(m_inputBuf.end(), iter, iter + count);
+        iter += count;
+        len -= count;
+
+        unsigned consumed = 0U;
+        if (!processFrames(&m_inputBuf[0], static_cast<unsigned>(m_inputBuf.size()), consumed, reason)) {
+            return false;
+        }
+
+        if (consumed > 0U) {
+            if constexpr (Config::HasZeroCopyRecv) {
+                // The batched messages reference the stored data
+                reportMsgsBatch();
+            }
+
+            m_inputBuf.clear();
+        }
+    }
+
+    return true;
+}
+
+bool ClientImpl::storeIncompleteFrame(const std::uint8_t* iter, unsigned len, DisconnectReason& reason)
+{
+    if (m_inputBuf.max_size() < std::max(len, m_pendingFrameLen)) {
+        errorLog("The incoming packet exceeds the input buffer capacity");
+        reason = DisconnectReason::PacketTooLarge;
+        return false;
+    }
+
+    COMMS_ASSERT(m_inputBuf.empty());
+    m_inputBuf.assign(iter, iter + len);
+    return true;
+}
+
+template <typename TOpsList>
+void ClientImpl::dispatchToOps(ProtMessage& msg, TOpsList& ops)
+{
+    // The ops can be completed (erased from the list) or new ones can be
+    // created during the dispatch. Do not dispatch the message to new ops.
+    auto count = ops.size();
+    auto idx = 0U;
+    while ((idx < count) && (idx < ops.size())) {
+        if (m_sessionState.m_disconnecting) {
+            break;
+        }
+
+        auto* op = ops[idx].get();
+        msg.dispatch(*op);
+
+        if ((idx < ops.size()) && (ops[idx].get() == op)) {
+            ++idx;
+            continue;
+        }
+
+        COMMS_ASSERT(0U < count);
+        --count;
+    }
+}
+
+template <typename TOpsList>
+void ClientImpl::dispatchToOpWithPacketId(ProtMessage& msg, TOpsList& ops, unsigned packetId)
+{
+    if (m_sessionState.m_disconnecting) {
+        return;
+    }
+
+    auto iter =
+        std::find_if(
+            ops.begin(), ops.end(),
+            [packetId](auto& opPtr)
+            {
+                return opPtr->packetId() == packetId;
+            });
+
+    if (iter == ops.end()) {
+        return;
+    }
+
+    msg.dispatch(**iter);
+}
+
+void ClientImpl::reportMsgsBatch()
+{
+    if constexpr (ExtConfig::HasMsgsBatch) {
+        if (m_batchedMsgs.empty() || m_reportingMsgsBatch) {
+            return;
+        }
+
+        m_reportingMsgsBatch = true;
+        m_batchedMsgInfos.clear();
+        m_batchedMsgInfos.reserve(m_batchedMsgs.size());
+        for (auto& batchedMsg : m_batchedMsgs) {
+            m_batchedMsgInfos.push_back(batchedMsg.m_info);
+            auto& info = m_batchedMsgInfos.back();
+            if (!batchedMsg.m_aliasTopic.empty()) {
+                info.m_topic = batchedMsg.m_aliasTopic.c_str();
+            }
+
+            if (!batchedMsg.m_userProps.empty()) {
+                info.m_userProps = &batchedMsg.m_userProps[0];
+            }
+
+            if (batchedMsg.m_lazyUserProps.m_fillFunc != nullptr) {
+                // The batched messages could have been relocated
+                batchedMsg.m_lazyUserProps.m_userProps = &batchedMsg.m_userProps;
+                info.m_lazyUserProps = batchedMsg.m_lazyUserProps.toHandle();
+            }
+
+            if (!batchedMsg.m_subIds.empty()) {
+                info.m_subIds = &batchedMsg.m_subIds[0];
+            }
+        }
+
+        COMMS_ASSERT(m_messagesReceivedReportCb != nullptr);
+        m_messagesReceivedReportCb(m_messagesReceivedReportData, &m_batchedMsgInfos[0], static_cast<unsigned>(m_batchedMsgInfos.size()));
+
+        for (auto& batchedMsg : m_batchedMsgs) {
+            if ((!m_sessionState.m_connected) || m_sessionState.m_disconnecting) {
+                // Not acknowledged, expected to be re-sent by the broker
+                break;
+            }
+
+            if constexpr (Config::MaxQos >= 1) {
+                if (batchedMsg.m_info.m_qos == CC_Mqtt5QoS_AtLeastOnceDelivery) {
+                    PubackMsg pubackMsg;
+                    pubackMsg.field_packetId().value() = batchedMsg.m_packetId;
+                    sendMessage(pubackMsg);
+                    COMMS_ASSERT(0U < m_batchedQos1Count);
+                    --m_batchedQos1Count;
+                    continue;
+                }
+            }
+
+            if constexpr (Config::MaxQos >= 2) {
+                if (batchedMsg.m_info.m_qos == CC_Mqtt5QoS_ExactlyOnceDelivery) {
+                    PubrecMsg pubrecMsg;
+                    pubrecMsg.field_packetId().setValue(batchedMsg.m_packetId);
+                    sendMessage(pubrecMsg);
+                }
+            }
+        }
+
+        m_batchedMsgs.clear();
+        m_batchedMsgInfos.clear();
+        m_batchedQos1Count = 0U; // Not acknowledged ones are expected to be re-sent by the broker
+        m_reportingMsgsBatch = false;
+    }
+}
+
+bool ClientImpl::isRecvFrameLenAllowed(unsigned frameLen)
+{
+    if ((m_sessionState.m_maxRecvPacketSize == 0U) ||
+        (frameLen <= m_sessionState.m_maxRecvPacketSize)) {
+        return true;
+    }
+
+    errorLog("The message length exceeded max packet size");
+    return false;
+}
+
 void ClientImpl::opComplete_Connect(const op::Op* op)
 {
     eraseFromList(op, m_connectOps);
@@ -1332,7 +2834,26 @@ void ClientImpl::opComplete_Recv(const op::Op* op)
 
 void ClientImpl::opComplete_Send(const op::Op* op)
 {
-    auto idx = eraseFromList(op, m_sendOps);
+    auto* sendOp = static_cast<const op::SendOp*>(op);
+    auto idx = sendOp->sendOpsIdx();
+    COMMS_ASSERT((idx < m_sendOps.size()) && (m_sendOps[idx].get() == sendOp));
+    if ((m_sendOps.size() <= idx) || (m_sendOps[idx].get() != sendOp)) {
+        return;
+    }
+
+    auto packetId = static_cast<std::uint16_t>(sendOp->packetId());
+    if (packetId != 0U) {
+        m_sendOpsPacketIds.erase(packetId);
+    }
+
+    // The send ops list is compacted on the last API exit
+    m_sendOps[idx]->releaseBufs(m_recycledSendBufs);
+    m_sendOps[idx].reset();
+    ++m_sendOpsDeletedCount;
+    while ((m_sendOpsHead < m_sendOps.size()) && (!m_sendOps[m_sendOpsHead])) {
+        ++m_sendOpsHead;
+    }
+
     if (m_sessionState.m_disconnecting) {
         return;
     }
@@ -1350,4 +2871,9 @@ void ClientImpl::sessionExpiryTimeoutCb(void* data)
     reinterpret_cast<ClientImpl*>(data)->sessionExpiryTimeoutInternal();
 }
 
+void ClientImpl::recvQos2TimeoutCb(void* data)
+{
+    reinterpret_cast<ClientImpl*>(data)->recvQos2TimeoutInternal();
+}
+
 } // namespace cc_mqtt5_client
@@ -12,10 +12,14 @@
 #include "ExtConfig.h"
 #include "ObjAllocator.h"
 #include "ObjListType.h"
+#include "PacketIdMap.h"
 #include "ProtocolDefs.h"
+#include "PublishTemplate.h"
+#include "ResponseTimeoutQueue.h"
 #include "ReuseState.h"
 #include "SessionState.h"
 #include "TimerMgr.h"
+#include "TopicAliasDefs.h"
 
 #include "op/ConnectOp.h"
 #include "op/DisconnectOp.h"
@@ -29,6 +33,10 @@
 
 #include "cc_mqtt5_client/common.h"
 
+#include <array>
+#include <cstdint>
+#include <limits>
+
 namespace cc_mqtt5_client
 {
 
@@ -65,16 +73,67 @@ public:
     // -------------------- API Calls -----------------------------
     void tick(unsigned ms);
     unsigned processData(const std::uint8_t* iter, unsigned len);
+    unsigned processDataV(const CC_Mqtt5DataSegment* segments, unsigned count);
     void notifyNetworkDisconnected();
     bool isNetworkDisconnected() const;
+    CC_Mqtt5ErrorCode setIncrementalRecvEnabled(bool enabled);
+    bool getIncrementalRecvEnabled() const
+    {
+        return m_configState.m_incrementalRecv;
+    }
+
+    CC_Mqtt5ErrorCode setLazyPropsEnabled(bool enabled);
+    bool getLazyPropsEnabled() const
+    {
+        return m_configState.m_lazyProps;
+    }
+
+    CC_Mqtt5ErrorCode fetchUserProps(op::Op::LazyUserProps* lazyProps, const CC_Mqtt5UserProp** props, unsigned* count);
+
+    CC_Mqtt5ErrorCode setAutoCorkEnabled(bool enabled);
+
+    bool getAutoCorkEnabled() const
+    {
+        return m_configState.m_autoCork;
+    }
+
+    void cork();
+    void uncork();
+    bool isCorked() const
+    {
+        return m_outputCorked;
+    }
 
     op::ConnectOp* connectPrepare(CC_Mqtt5ErrorCode* ec);
     op::DisconnectOp* disconnectPrepare(CC_Mqtt5ErrorCode* ec);
     op::SubscribeOp* subscribePrepare(CC_Mqtt5ErrorCode* ec);
     op::UnsubscribeOp* unsubscribePrepare(CC_Mqtt5ErrorCode* ec);
     op::SendOp* publishPrepare(CC_Mqtt5ErrorCode* ec);
+    CC_Mqtt5ErrorCode publishBatch(
+        const CC_Mqtt5PublishBasicConfig* basicConfigs,
+        const CC_Mqtt5PublishExtraConfig* extraConfigs,
+        unsigned count,
+        CC_Mqtt5PublishCompleteCb cb,
+        void* cbData,
+        unsigned* sentCount);
     op::ReauthOp* reauthPrepare(CC_Mqtt5ErrorCode* ec);
 
+    PublishTemplate* publishTemplateAlloc(
+        const CC_Mqtt5PublishBasicConfig& basic,
+        const CC_Mqtt5PublishExtraConfig* extra,
+        const CC_Mqtt5UserProp* userProps,
+        unsigned userPropsCount,
+        CC_Mqtt5ErrorCode* ec);
+    CC_Mqtt5ErrorCode publishTemplateFree(PublishTemplate* tmpl);
+    CC_Mqtt5ErrorCode publishTemplateSend(
+        PublishTemplate* tmpl,
+        const unsigned char* data,
+        unsigned dataLen,
+        const unsigned char* correlationData,
+        unsigned correlationDataLen,
+        CC_Mqtt5PublishCompleteCb cb,
+        void* cbData);
+
     CC_Mqtt5ErrorCode allocPubTopicAlias(const char* topic, unsigned qos0RegsCount);
     CC_Mqtt5ErrorCode freePubTopicAlias(const char* topic);
     CC_Mqtt5ErrorCode setPublishOrdering(CC_Mqtt5PublishOrdering ordering);
@@ -88,7 +147,7 @@ public:
 
     std::size_t sendsCount() const
     {
-        return m_sendOps.size();
+        return m_sendOps.size() - m_sendOpsDeletedCount;
     }
 
     void setNextTickProgramCallback(CC_Mqtt5NextTickProgramCb cb, void* data)
@@ -115,6 +174,25 @@ public:
         }
     }
 
+    void setSendOutputDataVCallback(CC_Mqtt5SendOutputDataVCb cb, void* data)
+    {
+        m_sendOutputDataVCb = cb;
+        m_sendOutputDataVData = data;
+    }
+
+    CC_Mqtt5ErrorCode setOutputBufProviderCallbacks(CC_Mqtt5OutputBufReserveCb reserveCb, CC_Mqtt5OutputBufCommitCb commitCb, void* data)
+    {
+        if ((reserveCb == nullptr) != (commitCb == nullptr)) {
+            errorLog("Both output buffer provider callbacks are expected to be set or cleared.");
+            return CC_Mqtt5ErrorCode_BadParam;
+        }
+
+        m_outputBufReserveCb = reserveCb;
+        m_outputBufCommitCb = commitCb;
+        m_outputBufProviderData = data;
+        return CC_Mqtt5ErrorCode_Success;
+    }
+
     void setBrokerDisconnectReportCallback(CC_Mqtt5BrokerDisconnectReportCb cb, void* data)
     {
         if (cb != nullptr) {
@@ -131,6 +209,8 @@ public:
         }
     }
 
+    CC_Mqtt5ErrorCode setMessagesReceivedCallback(CC_Mqtt5MessagesReceivedReportCb cb, void* data);
+
     void setErrorLogCallback(CC_Mqtt5ErrorLogCb cb, void* data)
     {
         m_errorLogCb = cb;
@@ -140,7 +220,8 @@ public:
     // -------------------- Message Handling -----------------------------
 
     using Base::handle;
-    virtual void handle(PublishMsg& msg) override;
+    virtual void handle(ConnackMsg& msg) override;
+    virtual void handle(RecvPublishMsg& msg) override;
 
 #if CC_MQTT5_CLIENT_MAX_QOS >= 1
     virtual void handle(PubackMsg& msg) override;
@@ -152,27 +233,68 @@ public:
     virtual void handle(PubcompMsg& msg) override;
 #endif // #if CC_MQTT5_CLIENT_MAX_QOS >= 2
 
+    virtual void handle(SubackMsg& msg) override;
+    virtual void handle(UnsubackMsg& msg) override;
+    virtual void handle(PingrespMsg& msg) override;
+    virtual void handle(DisconnectMsg& msg) override;
+    virtual void handle(AuthMsg& msg) override;
     virtual void handle(ProtMessage& msg) override;
 
     // -------------------- Ops Access API -----------------------------
 
-    CC_Mqtt5ErrorCode sendMessage(const ProtMessage& msg);
+    CC_Mqtt5ErrorCode sendMessage(const ProtMessage& msg, const std::uint8_t* payload = nullptr, std::size_t payloadLen = 0U);
+    CC_Mqtt5ErrorCode sendUncorkedMessage(const ProtMessage& msg);
+    CC_Mqtt5ErrorCode serializeMessage(const ProtMessage& msg, op::SendOp::EncodedMsgBuf& buf, std::size_t payloadLen = 0U);
+    CC_Mqtt5ErrorCode sendSerialized(const std::uint8_t* buf, std::size_t len, const std::uint8_t* payload = nullptr, std::size_t payloadLen = 0U);
     void opComplete(const op::Op* op);
+    void registerSendOpPacketId(op::SendOp& sendOp);
     void brokerConnected(bool sessionPresent);
     void brokerDisconnected(
         CC_Mqtt5BrokerDisconnectReason reason = CC_Mqtt5BrokerDisconnectReason_ValuesLimit,
         CC_Mqtt5AsyncOpStatus status = CC_Mqtt5AsyncOpStatus_BrokerDisconnected,
         const CC_Mqtt5DisconnectInfo* info = nullptr);
     void reportMsgInfo(const CC_Mqtt5MessageInfo& info);
+    void batchMsgInfo(
+        const CC_Mqtt5MessageInfo& info,
+        op::Op::UserPropsList& userProps,
+        const op::Op::LazyUserProps& lazyUserProps,
+        op::Op::SubIdsStorage& subIds,
+        const TopicStr* aliasTopic,
+        unsigned packetId);
+
+    bool isMsgsBatchEnabled() const
+    {
+        if constexpr (ExtConfig::HasMsgsBatch) {
+            return m_messagesReceivedReportCb != nullptr;
+        }
+        else {
+            return false;
+        }
+    }
     bool hasPausedSendsBefore(const op::SendOp* sendOp) const;
     bool hasHigherQosSendsBefore(const op::SendOp* sendOp, op::Op::Qos qos) const;
     void allowNextPrepare();
 
+    op::SendOp::PubMsgAlloc::Ptr allocPubMsg()
+    {
+        return m_pubMsgsAlloc.alloc();
+    }
+
+    op::SendOp::RecycledBufsList& recycledSendBufs()
+    {
+        return m_recycledSendBufs;
+    }
+
     TimerMgr& timerMgr()
     {
         return m_timerMgr;
     }
 
+    ResponseTimeoutQueue& responseTimeouts()
+    {
+        return m_responseTimeouts;
+    }
+
     ConfigState& configState()
     {
         return m_configState;
@@ -217,9 +339,11 @@ public:
 
     std::size_t recvsCount() const
     {
-        return m_recvOps.size();
+        return m_recvOps.size() + m_recvQos2.size() + m_batchedQos1Count;
     }
 
+    bool addPendingRecvQos2(std::uint16_t packetId);
+
 private:
     using ConnectOpAlloc = ObjAllocator<op::ConnectOp, ExtConfig::ConnectOpsLimit>;
     using ConnectOpsList = ObjListType<ConnectOpAlloc::Ptr, ExtConfig::ConnectOpsLimit>;
@@ -238,16 +362,49 @@ private:
 
     using RecvOpAlloc = ObjAllocator<op::RecvOp, ExtConfig::RecvOpsLimit>;
     using RecvOpsList = ObjListType<RecvOpAlloc::Ptr, ExtConfig::RecvOpsLimit>;
+    static constexpr std::uint64_t NoRecvQos2Deadline = std::numeric_limits<std::uint64_t>::max();
+
+    using RecvQos2Map = PacketIdMap<std::uint64_t, ExtConfig::RecvOpsLimit>; // PUBREL reception deadline
+
+    struct RecvQos2Timeout
+    {
+        std::uint64_t m_deadline = 0U;
+        std::uint16_t m_packetId = 0U;
+    };
+
+    using RecvQos2TimeoutsList = ObjListType<RecvQos2Timeout, ExtConfig::RecvOpsLimit>;
 
     using SendOpAlloc = ObjAllocator<op::SendOp, ExtConfig::SendOpsLimit>;
-    using SendOpsList = ObjListType<SendOpAlloc::Ptr, ExtConfig::SendOpsLimit>;
+    using SendOpsList = ObjListType<SendOpAlloc::Ptr, ExtConfig::SendOpsListLimit>;
+    using SendOpsPacketIdMap = PacketIdMap<op::SendOp*, ExtConfig::SendOpsLimit>;
+    using TransientSendOpAlloc = ObjAllocator<op::SendOp, 1U>;
 
     using ReauthOpAlloc = ObjAllocator<op::ReauthOp, ExtConfig::ReauthOpsLimit>;
     using ReauthOpsList = ObjListType<ReauthOpAlloc::Ptr, ExtConfig::ReauthOpsLimit>;
 
+    using PublishTemplateAlloc = ObjAllocator<PublishTemplate, ExtConfig::PublishTemplatesLimit>;
+    using PublishTemplatesList = ObjListType<PublishTemplateAlloc::Ptr, ExtConfig::PublishTemplatesLimit, ExtConfig::HasPublishTemplates>;
+
     using OpPtrsList = ObjListType<op::Op*, ExtConfig::OpsLimit>;
     using OpToDeletePtrsList = ObjListType<const op::Op*, ExtConfig::OpsLimit>;
     using OutputBuf = ObjListType<std::uint8_t, ExtConfig::MaxOutputPacketSize>;
+    using InputBuf = ObjListType<std::uint8_t, ExtConfig::MaxInputPacketSize, ExtConfig::HasIncrementalRecv>;
+    using DisconnectReason = DisconnectMsg::Field_reasonCode::Field::ValueType;
+
+    struct BatchedMsg
+    {
+        ProtMsgPtr m_msg; // Keeps the decoded data referenced by the info
+        CC_Mqtt5MessageInfo m_info = CC_Mqtt5MessageInfo();
+        op::Op::UserPropsList m_userProps;
+        op::Op::LazyUserProps m_lazyUserProps;
+        op::Op::SubIdsStorage m_subIds;
+        TopicStr m_aliasTopic;
+        unsigned m_packetId = 0U;
+    };
+
+    using BatchedMsgsList = ObjListType<BatchedMsg, 0U, ExtConfig::HasMsgsBatch>;
+    using BatchedMsgInfosList = ObjListType<CC_Mqtt5MessageInfo, 0U, ExtConfig::HasMsgsBatch>;
+    using BatchFramesList = std::array<ProtFrame, ExtConfig::InPlaceMsgsBatchLimit>;
 
     enum TerminateMode
     {
@@ -256,20 +413,60 @@ private:
         TerminateMode_NumOfValues
     };
 
+    enum SendOpsHint : unsigned
+    {
+        SendOpsHint_Unacked,
+        SendOpsHint_Paused,
+        SendOpsHint_HigherThanQos0,
+        SendOpsHint_HigherThanQos1,
+        SendOpsHint_NumOfValues
+    };
+
+    using SendOpsHints = std::array<unsigned, SendOpsHint_NumOfValues>;
+
     void doApiEnter();
     void doApiExit();
+    bool isOutputCorked() const;
+    bool isPublishAllowed(CC_Mqtt5ErrorCode* ec);
+    op::SendOp* allocSendOp(CC_Mqtt5ErrorCode* ec, PublishMsg* msg = nullptr);
+    TransientSendOpAlloc::Ptr allocTransientSendOp(CC_Mqtt5QoS qos, PublishMsg* msg = nullptr);
+    PublishTemplatesList::iterator findPublishTemplate(const PublishTemplate* tmpl);
+    void flushOutput();
+    CC_Mqtt5ErrorCode checkSendPacketLength(std::size_t len);
+    CC_Mqtt5ErrorCode sendSegments(const CC_Mqtt5DataSegment* segments, unsigned count);
+    CC_Mqtt5ErrorCode writeToProvidedBuf(const ProtMessage& msg, std::size_t len, const std::uint8_t* payload, std::size_t payloadLen, bool& written);
+    CC_Mqtt5ErrorCode appendPayload(std::size_t offset, const std::uint8_t* payload, std::size_t payloadLen);
+    void reportOutput(const std::uint8_t* buf, std::size_t len);
+    void reportMessageSent();
     void createKeepAliveOpIfNeeded();
     void terminateOps(CC_Mqtt5AsyncOpStatus status, TerminateMode mode);
-    void cleanOps();
+    void addOp(op::Op* op);
+    void cleanOps(bool force = false);
+    void reclaimSendOpsSlots();
     void errorLogInternal(const char* msg);
     void sendDisconnectMsg(DisconnectMsg::Field_reasonCode::Field::ValueType reason);
     CC_Mqtt5ErrorCode initInternal();
     void resumeSendOpsSince(unsigned idx);
     void sessionExpiryTimeoutInternal();
     op::SendOp* findSendOp(std::uint16_t packetId);
+
+    template <typename TFunc>
+    unsigned advanceSendOpsHint(SendOpsHint hint, unsigned untilIdx, TFunc&& func) const;
+
     bool isLegitSendAck(const op::SendOp* sendOp, bool pubcompAck = false) const;
     void resendAllUntil(op::SendOp* sendOp);
     bool processPublishAckMsg(ProtMessage& msg, std::uint16_t packetId, bool pubcompAck = false);
+    bool processFrames(const std::uint8_t* iter, unsigned len, unsigned& consumed, DisconnectReason& reason);
+    bool completeStoredFrame(const std::uint8_t*& iter, unsigned& len, DisconnectReason& reason);
+    bool storeIncompleteFrame(const std::uint8_t* iter, unsigned len, DisconnectReason& reason);
+    bool isRecvFrameLenAllowed(unsigned frameLen);
+    void reportMsgsBatch();
+
+    template <typename TOpsList>
+    void dispatchToOps(ProtMessage& msg, TOpsList& ops);
+
+    template <typename TOpsList>
+    void dispatchToOpWithPacketId(ProtMessage& msg, TOpsList& ops, unsigned packetId);
 
     void opComplete_Connect(const op::Op* op);
     void opComplete_KeepAlive(const op::Op* op);
@@ -280,7 +477,15 @@ private:
     void opComplete_Send(const op::Op* op);
     void opComplete_Reauth(const op::Op* op);
 
+    void restartRecvQos2Timeouts();
+    bool isRecvQos2TimeoutValid(const RecvQos2Timeout& timeout);
+    void compactRecvQos2Timeouts();
+    void programRecvQos2Timer();
+    void recvQos2TimeoutInternal();
+    void clearRecvQos2();
+
     static void sessionExpiryTimeoutCb(void* data);
+    static void recvQos2TimeoutCb(void* data);
 
     friend class ApiEnterGuard;
 
@@ -293,12 +498,22 @@ private:
     CC_Mqtt5SendOutputDataCb m_sendOutputDataCb = nullptr;
     void* m_sendOutputDataData = nullptr;
 
+    CC_Mqtt5SendOutputDataVCb m_sendOutputDataVCb = nullptr;
+    void* m_sendOutputDataVData = nullptr;
+
+    CC_Mqtt5OutputBufReserveCb m_outputBufReserveCb = nullptr;
+    CC_Mqtt5OutputBufCommitCb m_outputBufCommitCb = nullptr;
+    void* m_outputBufProviderData = nullptr;
+
     CC_Mqtt5BrokerDisconnectReportCb m_brokerDisconnectReportCb = nullptr;
     void* m_brokerDisconnectReportData = nullptr;
 
     CC_Mqtt5MessageReceivedReportCb m_messageReceivedReportCb = nullptr;
     void* m_messageReceivedReportData = nullptr;
 
+    CC_Mqtt5MessagesReceivedReportCb m_messagesReceivedReportCb = nullptr;
+    void* m_messagesReceivedReportData = nullptr;
+
     CC_Mqtt5ErrorLogCb m_errorLogCb = nullptr;
     void* m_errorLogData = nullptr;
 
@@ -307,12 +522,24 @@ private:
     SessionState m_sessionState;
     ReuseState m_reuseState;
 
+    BatchedMsgsList m_batchedMsgs;
+    BatchedMsgInfosList m_batchedMsgInfos;
+    BatchFramesList m_batchFrames;
+    unsigned m_batchedQos1Count = 0U; // Not acknowledged yet, counted towards "Receive Maximum"
+    bool m_reportingMsgsBatch = false;
+
     TimerMgr m_timerMgr;
+    ResponseTimeoutQueue m_responseTimeouts; // Must outlive the ops
     unsigned m_apiEnterCount = 0U;
 
     OutputBuf m_buf;
+    bool m_outputCorked = false;
+    bool m_outputBatched = false;
+    bool m_flushingOutput = false;
+    InputBuf m_inputBuf;
 
     ProtFrame m_frame;
+    unsigned m_pendingFrameLen = 0U;
 
     ConnectOpAlloc m_connectOpAlloc;
     ConnectOpsList m_connectOps;
@@ -331,16 +558,31 @@ private:
 
     RecvOpAlloc m_recvOpsAlloc;
     RecvOpsList m_recvOps;
+    RecvQos2Map m_recvQos2;
+    RecvQos2TimeoutsList m_recvQos2Timeouts; // Ordered by deadline, may contain outdated records
+    unsigned m_recvQos2TimeoutsHead = 0U;
 
+    op::SendOp::PubMsgAlloc m_pubMsgsAlloc; // Must outlive the send ops
     SendOpAlloc m_sendOpsAlloc;
     SendOpsList m_sendOps;
+    SendOpsPacketIdMap m_sendOpsPacketIds;
+    unsigned m_sendOpsHead = 0U; // First not completed send op
+    unsigned m_sendOpsDeletedCount = 0U;
+    mutable SendOpsHints m_sendOpsHints = SendOpsHints(); // First ops matching the conditions of the ordering checks
+    PublishMsg m_transientPubMsg; // Reused by the transient publishes, must outlive them
+    TransientSendOpAlloc m_transientSendOpAlloc; // Stateless QoS0 publishes
+    op::SendOp::RecycledBufsList m_recycledSendBufs; // Buffers of the completed send ops
 
     ReauthOpAlloc m_reauthOpsAlloc;
     ReauthOpsList m_reauthOps;
 
+    PublishTemplateAlloc m_publishTemplatesAlloc;
+    PublishTemplatesList m_publishTemplates;
+
     OpPtrsList m_ops;
     TimerMgr::Timer m_sessionExpiryTimer;
-    bool m_opsDeleted = false;
+    TimerMgr::Timer m_recvQos2Timer;
+    unsigned m_opsDeletedCount = 0U;
     bool m_preparationLocked = false;
 };
 
@@ -9,6 +9,7 @@
 
 #include "ExtConfig.h"
 #include "ObjListType.h"
+#include "PacketIdAllocator.h"
 #include "ProtocolDefs.h"
 #include "TopicAliasDefs.h"
 
@@ -21,14 +22,13 @@ namespace cc_mqtt5_client
 
 struct ClientState
 {
-    using PacketIdsList = ObjListType<std::uint16_t, ExtConfig::PacketIdsLimit>;
+    using PacketIdsAlloc = PacketIdAllocator<ExtConfig::PacketIdsLimit>;
 
     static constexpr unsigned DefaultKeepAlive = 60;
     static constexpr unsigned DefaultTopicAliasMax = 10;
 
     SendTopicsMap m_sendTopicAliases;
-    PacketIdsList m_allocatedPacketIds;
-    std::uint16_t m_lastPacketId = 0U;
+    PacketIdsAlloc m_packetIdsAlloc;
     unsigned m_inFlightSends = 0U;
 
     bool m_initialized = false;
@@ -20,6 +20,9 @@ struct ConfigState
     bool m_verifyOutgoingTopic = Config::HasTopicFormatVerification;
     bool m_verifyIncomingTopic = Config::HasTopicFormatVerification;
     bool m_verifySubFilter = Config::HasSubTopicVerification;
+    bool m_incrementalRecv = false;
+    bool m_lazyProps = false;
+    bool m_autoCork = false;
 };
 
 } // namespace cc_mqtt5_client
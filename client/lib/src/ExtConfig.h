@@ -16,22 +16,31 @@ namespace cc_mqtt5_client
 
 struct ExtConfig : public Config
 {
+    static constexpr bool HasIncrementalRecv = HasDynMemAlloc || (MaxInputPacketSize > 0U);
+    static constexpr bool HasMsgsBatch = HasDynMemAlloc;
+    static constexpr bool HasAutoCork = (MaxOutputPacketSize == 0U); // The output buffer must be able to grow
+    static constexpr unsigned InPlaceMsgsBatchLimit = (HasMsgsBatch && HasInPlaceMsgAlloc) ? 16U : 0U; // Every batched message occupies its own in-place storage
+    static constexpr bool HasPublishCache = HasDynMemAlloc;
+    static constexpr bool HasPublishTemplates = HasDynMemAlloc || (PublishTemplatesLimit > 0U);
+    static constexpr bool HasObjRecycling = HasDynMemAlloc && (RecycledObjsLimit > 0U);
     static constexpr unsigned ConnectOpsLimit = HasDynMemAlloc ? 0 : 1U;
     static constexpr unsigned KeepAliveOpsLimit = HasDynMemAlloc ? 0 : 1U;
     static constexpr unsigned ClientTimersLimit = HasDynMemAlloc ? 0 : 1U;
-    static constexpr unsigned ClientTimers = 1U;
+    static constexpr unsigned ClientTimers = 3U;
     static constexpr unsigned ConnectOpTimers = 1U;
     static constexpr unsigned KeepAliveOpTimers = 3U;
     static constexpr unsigned DisconnectOpsLimit = HasDynMemAlloc ? 0 : 1U;
     static constexpr unsigned DisconnectOpTimers = 0U;
-    static constexpr unsigned SubscribeOpTimers = 1U;
-    static constexpr unsigned UnsubscribeOpTimers = 1U;
+    static constexpr unsigned SubscribeOpTimers = 0U;
+    static constexpr unsigned UnsubscribeOpTimers = 0U;
     static constexpr unsigned RecvOpsLimit = ReceiveMaxLimit == 0U ? 0U : ReceiveMaxLimit + 1U;
-    static constexpr unsigned RecvOpTimers = 1U;
+    static constexpr unsigned RecvOpTimers = 0U;
     static constexpr unsigned SendOpsLimit = SendMaxLimit == 0U ? 0U : SendMaxLimit + 1U;
-    static constexpr unsigned SendOpTimers = 1U;
+    static constexpr unsigned SendOpsListLimit = SendOpsLimit * 2U; // Completed ops are removed on API exit
+    static constexpr unsigned SendOpTimers = 0U;
+    static constexpr unsigned PubMsgsLimit = SendOpsLimit; // The transient QoS0 publish reuses the client's message
     static constexpr unsigned ReauthOpsLimit = HasDynMemAlloc ? 0 : 1U;
-    static constexpr unsigned ReauthOpTimers = 1U;
+    static constexpr unsigned ReauthOpTimers = 0U;
     static constexpr bool HasOpsLimit =
         (ConnectOpsLimit > 0U) &&
         (KeepAliveOpsLimit > 0U) &&
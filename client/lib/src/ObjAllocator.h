@@ -7,27 +7,137 @@
 
 #pragma once
 
+#include "ExtConfig.h"
+
+#include "comms/Assert.h"
 #include "comms/util/alloc.h"
+#include "comms/util/ScopeGuard.h"
 #include "comms/util/type_traits.h"
 
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 namespace cc_mqtt5_client
 {
 
+namespace details
+{
+
+// Dynamic memory allocator keeping the memory of the released objects
+// for reuse. Up to TRecycleLimit blocks are kept, the rest are freed.
+template <typename TObj, unsigned TRecycleLimit>
+class RecyclingDynMemory
+{
+public:
+    class Deleter
+    {
+    public:
+        Deleter() = default;
+        explicit Deleter(RecyclingDynMemory* pool) : m_pool(pool) {}
+
+        void operator()(TObj* obj) const
+        {
+            COMMS_ASSERT(m_pool != nullptr);
+            m_pool->release(obj);
+        }
+
+    private:
+        RecyclingDynMemory* m_pool = nullptr;
+    };
+
+    using Ptr = std::unique_ptr<TObj, Deleter>;
+
+    RecyclingDynMemory() = default;
+    RecyclingDynMemory(const RecyclingDynMemory&) = delete;
+    RecyclingDynMemory& operator=(const RecyclingDynMemory&) = delete;
+
+    ~RecyclingDynMemory()
+    {
+        for (auto* block : m_freeBlocks) {
+            ::operator delete(block);
+        }
+    }
+
+    template <typename TAllocObj, typename... TArgs>
+    Ptr alloc(TArgs&&... args)
+    {
+        static_assert(std::is_same<TAllocObj, TObj>::value, "Only the same object type is expected");
+        void* block = nullptr;
+        if (m_freeBlocks.empty()) {
+            block = ::operator new(sizeof(TObj));
+        }
+        else {
+            block = m_freeBlocks.back();
+            m_freeBlocks.pop_back();
+        }
+
+        auto releaseOnError =
+            comms::util::makeScopeGuard(
+                [this, block]()
+                {
+                    m_freeBlocks.push_back(block);
+                });
+
+        auto* obj = new (block) TObj(std::forward<TArgs>(args)...);
+        releaseOnError.release();
+        return Ptr(obj, Deleter(this));
+    }
+
+    Ptr wrap(TObj* obj)
+    {
+        return Ptr(obj, Deleter(this));
+    }
+
+private:
+    static_assert(alignof(TObj) <= alignof(std::max_align_t), "Over-aligned objects are not supported");
+
+    void release(TObj* obj)
+    {
+        obj->~TObj();
+        if (TRecycleLimit <= m_freeBlocks.size()) {
+            ::operator delete(obj);
+            return;
+        }
+
+        m_freeBlocks.push_back(obj);
+    }
+
+    std::vector<void*> m_freeBlocks;
+};
+
+} // namespace details
+
 template <typename TObj, unsigned TLimit>
 class ObjAllocator
 {
     template <typename ...>
     using DynMemoryAlloc = comms::util::alloc::DynMemory<TObj>;
 
+    template <typename ...>
+    using RecyclingAlloc = details::RecyclingDynMemory<TObj, ExtConfig::RecycledObjsLimit>;
+
     template <typename ...>
     using InPlaceAlloc = comms::util::alloc::InPlacePool<TObj, TLimit>;
 
+    template <typename... TParams>
+    using HeapAlloc =
+        typename comms::util::LazyShallowConditional<
+            ExtConfig::HasObjRecycling
+        >::template Type<
+            RecyclingAlloc,
+            DynMemoryAlloc
+        >;
+
     template <typename... TParams>
     using Alloc =
         typename comms::util::LazyShallowConditional<
             TLimit == 0U
         >::template Type<
-            DynMemoryAlloc,
+            HeapAlloc,
             InPlaceAlloc
         >;
 
@@ -0,0 +1,184 @@
+//
+// Copyright 2023 - 2026 (C). Alex Robenko. All rights reserved.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include "ObjListType.h"
+
+#include "comms/Assert.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace cc_mqtt5_client
+{
+
+namespace details
+{
+
+static constexpr unsigned PacketIdsCount = static_cast<unsigned>(std::numeric_limits<std::uint16_t>::max()) + 1U;
+
+// Sorted list of the allocated packet IDs, used when only a small number
+// of IDs can be allocated at the same time.
+template <unsigned TLimit>
+class PacketIdListAllocator
+{
+public:
+    std::uint16_t alloc()
+    {
+        if ((m_allocated.max_size() <= m_allocated.size()) ||
+            ((PacketIdsCount - 1U) <= m_allocated.size())) {
+            return 0U;
+        }
+
+        auto nextPacketId = static_cast<std::uint16_t>(m_lastPacketId + 1U);
+
+        if (nextPacketId == 0U) {
+            nextPacketId = 1U;
+        }
+
+        while (true) {
+            if (m_allocated.empty() || (m_allocated.back() < nextPacketId)) {
+                m_allocated.push_back(nextPacketId);
+                break;
+            }
+
+            auto iter = std::lower_bound(m_allocated.begin(), m_allocated.end(), nextPacketId);
+            if ((iter == m_allocated.end()) || (*iter != nextPacketId)) {
+                m_allocated.insert(iter, nextPacketId);
+                break;
+            }
+
+            ++nextPacketId;
+            if (nextPacketId == 0U) {
+                nextPacketId = 1U;
+            }
+        }
+
+        m_lastPacketId = nextPacketId;
+        return m_lastPacketId;
+    }
+
+    bool release(std::uint16_t id)
+    {
+        auto iter = std::lower_bound(m_allocated.begin(), m_allocated.end(), id);
+        if ((iter == m_allocated.end()) || (*iter != id)) {
+            return false;
+        }
+
+        m_allocated.erase(iter);
+        return true;
+    }
+
+private:
+    using PacketIdsList = ObjListType<std::uint16_t, TLimit>;
+
+    PacketIdsList m_allocated;
+    std::uint16_t m_lastPacketId = 0U;
+};
+
+// Bitmap of all the packet IDs, every allocation / release is O(1) with
+// at most single pass over the bitmap words when looking for a free ID.
+class PacketIdBitmapAllocator
+{
+public:
+    PacketIdBitmapAllocator()
+    {
+        m_bitmap.fill(0U);
+        m_bitmap[0] = 1U; // Packet ID 0 is never allocated
+    }
+
+    std::uint16_t alloc()
+    {
+        if ((PacketIdsCount - 1U) <= m_count) {
+            return 0U;
+        }
+
+        auto nextPacketId = static_cast<unsigned>(static_cast<std::uint16_t>(m_lastPacketId + 1U));
+        auto wordIdx = nextPacketId / WordBits;
+
+        // Ignore the IDs preceding the next one in the first checked word
+        auto word = m_bitmap[wordIdx] | lowBitsMask(nextPacketId % WordBits);
+        for (auto count = 0U; count <= WordsCount; ++count) {
+            if (word != AllOnes) {
+                break;
+            }
+
+            wordIdx = (wordIdx + 1U) % WordsCount;
+            word = m_bitmap[wordIdx];
+        }
+
+        COMMS_ASSERT(word != AllOnes);
+        auto id = (wordIdx * WordBits) + findFirstZero(word);
+        COMMS_ASSERT((0U < id) && (id < PacketIdsCount));
+        m_bitmap[wordIdx] |= (Word(1U) << (id % WordBits));
+        ++m_count;
+        m_lastPacketId = static_cast<std::uint16_t>(id);
+        return m_lastPacketId;
+    }
+
+    bool release(std::uint16_t id)
+    {
+        auto& word = m_bitmap[id / WordBits];
+        auto mask = Word(1U) << (id % WordBits);
+        if ((id == 0U) || ((word & mask) == 0U)) {
+            return false;
+        }
+
+        word &= ~mask;
+        --m_count;
+        return true;
+    }
+
+private:
+    using Word = std::uint64_t;
+    static constexpr unsigned WordBits = std::numeric_limits<Word>::digits;
+    static constexpr unsigned WordsCount = PacketIdsCount / WordBits;
+    static constexpr Word AllOnes = std::numeric_limits<Word>::max();
+
+    static Word lowBitsMask(unsigned count)
+    {
+        return (Word(1U) << count) - 1U;
+    }
+
+    static unsigned findFirstZero(Word word)
+    {
+        COMMS_ASSERT(word != AllOnes);
+        auto bits = ~word;
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_ctzll(bits));
+#else // #if defined(__GNUC__) || defined(__clang__)
+        unsigned result = 0U;
+        while ((bits & 1U) == 0U) {
+            bits >>= 1U;
+            ++result;
+        }
+        return result;
+#endif // #if defined(__GNUC__) || defined(__clang__)
+    }
+
+    std::array<Word, WordsCount> m_bitmap;
+    unsigned m_count = 0U;
+    std::uint16_t m_lastPacketId = 0U;
+};
+
+} // namespace details
+
+// The bitmap occupies 8KB, the small bare metal configurations
+// keep the sorted list of the allocated IDs instead.
+template <unsigned TLimit>
+using PacketIdAllocator =
+    std::conditional_t<
+        (TLimit == 0U) || ((details::PacketIdsCount / 8U) <= (TLimit * sizeof(std::uint16_t))),
+        details::PacketIdBitmapAllocator,
+        details::PacketIdListAllocator<TLimit>
+    >;
+
+} // namespace cc_mqtt5_client
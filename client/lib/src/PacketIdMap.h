@@ -0,0 +1,214 @@
+//
+// Copyright 2023 - 2026 (C). Alex Robenko. All rights reserved.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include "ObjListType.h"
+
+#include "comms/Assert.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace cc_mqtt5_client
+{
+
+// Open addressing (linear probing) hash table mapping the packet ID to the value.
+// The packet IDs are allocated sequentially, as the result the identity hash
+// distributes them evenly. The packet ID 0 marks an empty slot.
+template <typename TValue, unsigned TLimit>
+class PacketIdMap
+{
+    static constexpr unsigned calcCapacity(unsigned limit)
+    {
+        unsigned result = 1U;
+        while (result < (limit * 2U)) {
+            result <<= 1U;
+        }
+        return result;
+    }
+
+    static constexpr unsigned MinCapacity = 16U;
+    static constexpr unsigned Capacity = (TLimit == 0U) ? 0U : calcCapacity(TLimit);
+
+public:
+    PacketIdMap()
+    {
+        if constexpr (Capacity > 0U) {
+            m_entries.resize(Capacity);
+        }
+    }
+
+    bool insert(std::uint16_t packetId, TValue value)
+    {
+        COMMS_ASSERT(packetId != 0U);
+        if (!reserveFor(m_count + 1U)) {
+            return false;
+        }
+
+        auto idx = findSlot(packetId);
+        auto& entry = m_entries[idx];
+        if (entry.m_packetId == 0U) {
+            ++m_count;
+        }
+
+        entry.m_packetId = packetId;
+        entry.m_value = value;
+        return true;
+    }
+
+    TValue find(std::uint16_t packetId) const
+    {
+        if (m_count == 0U) {
+            return TValue();
+        }
+
+        return m_entries[findSlot(packetId)].m_value;
+    }
+
+    TValue* lookup(std::uint16_t packetId)
+    {
+        if (m_count == 0U) {
+            return nullptr;
+        }
+
+        auto& entry = m_entries[findSlot(packetId)];
+        if (entry.m_packetId == 0U) {
+            return nullptr;
+        }
+
+        return &entry.m_value;
+    }
+
+    void erase(std::uint16_t packetId)
+    {
+        if (m_count == 0U) {
+            return;
+        }
+
+        auto idx = findSlot(packetId);
+        if (m_entries[idx].m_packetId == 0U) {
+            return;
+        }
+
+        eraseSlot(idx);
+    }
+
+    template <typename TFunc>
+    void forEach(TFunc&& func)
+    {
+        for (auto& entry : m_entries) {
+            if (entry.m_packetId != 0U) {
+                func(entry.m_packetId, entry.m_value);
+            }
+        }
+    }
+
+    template <typename TPred>
+    void eraseIf(TPred&& pred)
+    {
+        // The backward shift can move only not yet visited entries into
+        // the erased slot, re-check the same slot after erase.
+        for (auto idx = 0U; idx < m_entries.size(); ++idx) {
+            while ((m_entries[idx].m_packetId != 0U) && pred(m_entries[idx].m_packetId, m_entries[idx].m_value)) {
+                eraseSlot(idx);
+            }
+        }
+    }
+
+    void clear()
+    {
+        for (auto& entry : m_entries) {
+            entry = Entry();
+        }
+
+        m_count = 0U;
+    }
+
+    std::size_t size() const
+    {
+        return m_count;
+    }
+
+private:
+    struct Entry
+    {
+        std::uint16_t m_packetId = 0U;
+        TValue m_value = TValue();
+    };
+
+    using EntriesList = ObjListType<Entry, Capacity>;
+
+    unsigned capacityMask() const
+    {
+        COMMS_ASSERT(!m_entries.empty());
+        return static_cast<unsigned>(m_entries.size()) - 1U;
+    }
+
+    unsigned findSlot(std::uint16_t packetId) const
+    {
+        auto mask = capacityMask();
+        auto idx = packetId & mask;
+        while ((m_entries[idx].m_packetId != 0U) && (m_entries[idx].m_packetId != packetId)) {
+            idx = (idx + 1U) & mask;
+        }
+
+        return idx;
+    }
+
+    void eraseSlot(unsigned idx)
+    {
+        // Backward shift deletion, no tombstones are needed
+        auto mask = capacityMask();
+        auto nextIdx = (idx + 1U) & mask;
+        while (m_entries[nextIdx].m_packetId != 0U) {
+            auto homeIdx = m_entries[nextIdx].m_packetId & mask;
+            if (((nextIdx - homeIdx) & mask) >= ((nextIdx - idx) & mask)) {
+                m_entries[idx] = m_entries[nextIdx];
+                idx = nextIdx;
+            }
+
+            nextIdx = (nextIdx + 1U) & mask;
+        }
+
+        m_entries[idx] = Entry();
+        --m_count;
+    }
+
+    bool reserveFor(std::size_t count)
+    {
+        if ((count * 2U) <= m_entries.size()) {
+            return true;
+        }
+
+        if constexpr (Capacity > 0U) {
+            // The capacity is calculated to fit all the allowed operations
+            return count <= TLimit;
+        }
+        else {
+            auto newCapacity = std::max(std::size_t(MinCapacity), m_entries.size() * 2U);
+            while (newCapacity < (count * 2U)) {
+                newCapacity *= 2U;
+            }
+
+            EntriesList oldEntries(newCapacity);
+            oldEntries.swap(m_entries);
+            for (auto& entry : oldEntries) {
+                if (entry.m_packetId != 0U) {
+                    m_entries[findSlot(entry.m_packetId)] = entry;
+                }
+            }
+
+            return true;
+        }
+    }
+
+    EntriesList m_entries;
+    std::size_t m_count = 0U;
+};
+
+} // namespace cc_mqtt5_client
@@ -16,12 +16,13 @@
 namespace cc_mqtt5_client
 {
 
-class PropsHandler
+template <typename TOpt>
+class BasicPropsHandler
 {
-    using Property = cc_mqtt5::field::Property<ProtocolOptions>;
+    using Property = cc_mqtt5::field::Property<TOpt>;
 
 public:
-    using PayloadFormatIndicator = Property::Field_payloadFormatIndicator;
+    using PayloadFormatIndicator = typename Property::Field_payloadFormatIndicator;
     const PayloadFormatIndicator* m_payloadFormatIndicator = nullptr;
     template <std::size_t TIdx>
     void operator()(const PayloadFormatIndicator& field)
@@ -29,7 +30,7 @@ public:
         storeProp(field, m_payloadFormatIndicator);
     }
 
-    using MessageExpiryInterval = Property::Field_messageExpiryInterval;
+    using MessageExpiryInterval = typename Property::Field_messageExpiryInterval;
     const MessageExpiryInterval* m_messageExpiryInterval = nullptr;
     template <std::size_t TIdx>
     void operator()(const MessageExpiryInterval& field)
@@ -37,7 +38,7 @@ public:
         storeProp(field, m_messageExpiryInterval);
     }
 
-    using ContentType = Property::Field_contentType;
+    using ContentType = typename Property::Field_contentType;
     const ContentType* m_contentType = nullptr;
     template <std::size_t TIdx>
     void operator()(const ContentType& field)
@@ -45,7 +46,7 @@ public:
         storeProp(field, m_contentType);
     }
 
-    using ResponseTopic = Property::Field_responseTopic;
+    using ResponseTopic = typename Property::Field_responseTopic;
     const ResponseTopic* m_responseTopic = nullptr;
     template <std::size_t TIdx>
     void operator()(const ResponseTopic& field)
@@ -53,7 +54,7 @@ public:
         storeProp(field, m_responseTopic);
     }
 
-    using CorrelationData = Property::Field_correlationData;
+    using CorrelationData = typename Property::Field_correlationData;
     const CorrelationData* m_correlationData = nullptr;
     template <std::size_t TIdx>
     void operator()(const CorrelationData& field)
@@ -61,7 +62,7 @@ public:
         storeProp(field, m_correlationData);
     }
 
-    using SubscriptionId = Property::Field_subscriptionId;
+    using SubscriptionId = typename Property::Field_subscriptionId;
     using SubscriptionIdsList = ObjListType<const SubscriptionId*, Config::SubIdsLimit, Config::HasSubIds>;
     SubscriptionIdsList m_subscriptionIds;
     template <std::size_t TIdx>
@@ -79,7 +80,7 @@ public:
         }
     }
 
-    using SessionExpiryInterval = Property::Field_sessionExpiryInterval;
+    using SessionExpiryInterval = typename Property::Field_sessionExpiryInterval;
     const SessionExpiryInterval* m_sessionExpiryInterval = nullptr;
     template <std::size_t TIdx>
     void operator()(const SessionExpiryInterval& field)
@@ -87,7 +88,7 @@ public:
         storeProp(field, m_sessionExpiryInterval);
     }
 
-    using AssignedClientId = Property::Field_assignedClientId;
+    using AssignedClientId = typename Property::Field_assignedClientId;
     const AssignedClientId* m_assignedClientId = nullptr;
     template <std::size_t TIdx>
     void operator()(const AssignedClientId& field)
@@ -95,7 +96,7 @@ public:
         storeProp(field, m_assignedClientId);
     }
 
-    using ServerKeepAlive = Property::Field_serverKeepAlive;
+    using ServerKeepAlive = typename Property::Field_serverKeepAlive;
     const ServerKeepAlive* m_serverKeepAlive = nullptr;
     template <std::size_t TIdx>
     void operator()(const ServerKeepAlive& field)
@@ -103,7 +104,7 @@ public:
         storeProp(field, m_serverKeepAlive);
     }
 
-    using AuthMethod = Property::Field_authMethod;
+    using AuthMethod = typename Property::Field_authMethod;
     const AuthMethod* m_authMethod = nullptr;
     template <std::size_t TIdx>
     void operator()(const AuthMethod& field)
@@ -111,7 +112,7 @@ public:
         storeProp(field, m_authMethod);
     }
 
-    using AuthData = Property::Field_authData;
+    using AuthData = typename Property::Field_authData;
     const AuthData* m_authData = nullptr;
     template <std::size_t TIdx>
     void operator()(const AuthData& field)
@@ -119,7 +120,7 @@ public:
         storeProp(field, m_authData);
     }
 
-    using RequestProblemInfo = Property::Field_requestProblemInfo;
+    using RequestProblemInfo = typename Property::Field_requestProblemInfo;
     const RequestProblemInfo* m_requestProblemInfo = nullptr;
     template <std::size_t TIdx>
     void operator()(const RequestProblemInfo& field)
@@ -127,7 +128,7 @@ public:
         storeProp(field, m_requestProblemInfo);
     }
 
-    using WillDelayInterval = Property::Field_willDelayInterval;
+    using WillDelayInterval = typename Property::Field_willDelayInterval;
     const WillDelayInterval* m_willDelayInterval = nullptr;
     template <std::size_t TIdx>
     void operator()(const WillDelayInterval& field)
@@ -135,7 +136,7 @@ public:
         storeProp(field, m_willDelayInterval);
     }
 
-    using RequestResponseInfo = Property::Field_requestResponseInfo;
+    using RequestResponseInfo = typename Property::Field_requestResponseInfo;
     const RequestResponseInfo* m_requestResponseInfo = nullptr;
     template <std::size_t TIdx>
     void operator()(const RequestResponseInfo& field)
@@ -143,7 +144,7 @@ public:
         storeProp(field, m_requestResponseInfo);
     }
 
-    using ResponseInfo = Property::Field_responseInfo;
+    using ResponseInfo = typename Property::Field_responseInfo;
     const ResponseInfo* m_responseInfo = nullptr;
     template <std::size_t TIdx>
     void operator()(const ResponseInfo& field)
@@ -151,7 +152,7 @@ public:
         storeProp(field, m_responseInfo);
     }
 
-    using ServerRef = Property::Field_serverRef;
+    using ServerRef = typename Property::Field_serverRef;
     const ServerRef* m_serverRef = nullptr;
     template <std::size_t TIdx>
     void operator()(const ServerRef& field)
@@ -159,7 +160,7 @@ public:
         storeProp(field, m_serverRef);
     }
 
-    using ReasonStr = Property::Field_reasonStr;
+    using ReasonStr = typename Property::Field_reasonStr;
     const ReasonStr* m_reasonStr = nullptr;
     template <std::size_t TIdx>
     void operator()(const ReasonStr& field)
@@ -167,7 +168,7 @@ public:
         storeProp(field, m_reasonStr);
     }
 
-    using ReceiveMax = Property::Field_receiveMax;
+    using ReceiveMax = typename Property::Field_receiveMax;
     const ReceiveMax* m_receiveMax = nullptr;
     template <std::size_t TIdx>
     void operator()(const ReceiveMax& field)
@@ -178,7 +179,7 @@ public:
         }
     }
 
-    using TopicAliasMax = Property::Field_topicAliasMax;
+    using TopicAliasMax = typename Property::Field_topicAliasMax;
     const TopicAliasMax* m_topicAliasMax = nullptr;
     template <std::size_t TIdx>
     void operator()(const TopicAliasMax& field)
@@ -186,7 +187,7 @@ public:
         storeProp(field, m_topicAliasMax);
     }
 
-    using TopicAlias = Property::Field_topicAlias;
+    using TopicAlias = typename Property::Field_topicAlias;
     const TopicAlias* m_topicAlias = nullptr;
     template <std::size_t TIdx>
     void operator()(const TopicAlias& field)
@@ -194,7 +195,7 @@ public:
         storeProp(field, m_topicAlias);
     }
 
-    using MaxQos = Property::Field_maxQos;
+    using MaxQos = typename Property::Field_maxQos;
     const MaxQos* m_maxQos = nullptr;
     template <std::size_t TIdx>
     void operator()(const MaxQos& field)
@@ -205,7 +206,7 @@ public:
         }
     }
 
-    using RetainAvailable = Property::Field_retainAvailable;
+    using RetainAvailable = typename Property::Field_retainAvailable;
     const RetainAvailable* m_retainAvailable = nullptr;
     template <std::size_t TIdx>
     void operator()(const RetainAvailable& field)
@@ -216,13 +217,20 @@ public:
         }
     }
 
-    using UserProperty = Property::Field_userProperty;
+    using UserProperty = typename Property::Field_userProperty;
     using UserPropsList = ObjListType<const UserProperty*, Config::UserPropsLimit, Config::HasUserProps>;
     UserPropsList m_userProps;
+    bool m_lazyUserProps = false; // Only record presence of the user properties, don't collect them
+    bool m_hasLazyUserProps = false;
     template <std::size_t TIdx>
     void operator()(const UserProperty& field)
     {
         if constexpr (Config::HasUserProps) {
+            if (m_lazyUserProps) {
+                m_hasLazyUserProps = true;
+                return;
+            }
+
             if (m_userProps.max_size() <= m_userProps.size()) {
                 return;
             }
@@ -231,7 +239,7 @@ public:
         }
     }
 
-    using MaxPacketSize = Property::Field_maxPacketSize;
+    using MaxPacketSize = typename Property::Field_maxPacketSize;
     const MaxPacketSize* m_maxPacketSize = nullptr;
     template <std::size_t TIdx>
     void operator()(const MaxPacketSize& field)
@@ -242,7 +250,7 @@ public:
         }
     }
 
-    using WildcardSubAvail = Property::Field_wildcardSubAvail;
+    using WildcardSubAvail = typename Property::Field_wildcardSubAvail;
     const WildcardSubAvail* m_wildcardSubAvail = nullptr;
     template <std::size_t TIdx>
     void operator()(const WildcardSubAvail& field)
@@ -253,7 +261,7 @@ public:
         }
     }
 
-    using SubIdAvail = Property::Field_subIdAvail;
+    using SubIdAvail = typename Property::Field_subIdAvail;
     const SubIdAvail* m_subIdAvail = nullptr;
     template <std::size_t TIdx>
     void operator()(const SubIdAvail& field)
@@ -264,7 +272,7 @@ public:
         }
     }
 
-    using SharedSubAvail = Property::Field_sharedSubAvail;
+    using SharedSubAvail = typename Property::Field_sharedSubAvail;
     const SharedSubAvail* m_sharedSubAvail = nullptr;
     template <std::size_t TIdx>
     void operator()(const SharedSubAvail& field)
@@ -280,6 +288,11 @@ public:
         return m_protocolError;
     }
 
+    bool hasUserProps() const
+    {
+        return (!m_userProps.empty()) || m_hasLazyUserProps;
+    }
+
 private:
     template <typename TField>
     void storeProp(const TField& field, const TField*& ptr)
@@ -294,4 +307,6 @@ private:
     bool m_protocolError = false;
 };
 
+using PropsHandler = BasicPropsHandler<ProtocolOptions>;
+
 } // namespace cc_mqtt5_client
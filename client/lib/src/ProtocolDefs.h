@@ -14,7 +14,6 @@
 #include "cc_mqtt5/Version.h"
 #include "cc_mqtt5/frame/Frame.h"
 #include "cc_mqtt5/input/AllMessages.h"
-#include "cc_mqtt5/input/ClientInputMessages.h"
 
 #include "comms/GenericHandler.h"
 
@@ -38,11 +37,36 @@ using ProtMessage = cc_mqtt5::Message<
 
 CC_MQTT5_ALIASES_FOR_ALL_MESSAGES(, Msg, ProtMessage, ProtocolOptions)
 
-template <typename TBase, typename TOpt>
+using RecvPublishOptions =
+    std::conditional_t<
+        Config::HasZeroCopyRecv,
+        RecvPublishProtocolOptions,
+        ProtocolOptions
+    >;
+
+using RecvPublishMsg = cc_mqtt5::message::Publish<ProtMessage, RecvPublishOptions>;
+
+template <typename TBase, typename TOpt, typename TRecvPublishOpt>
+using Qos2ClientInputMessages =
+    std::tuple<
+        cc_mqtt5::message::Connack<TBase, TOpt>,
+        cc_mqtt5::message::Publish<TBase, TRecvPublishOpt>,
+        cc_mqtt5::message::Puback<TBase, TOpt>,
+        cc_mqtt5::message::Pubrec<TBase, TOpt>,
+        cc_mqtt5::message::Pubrel<TBase, TOpt>,
+        cc_mqtt5::message::Pubcomp<TBase, TOpt>,
+        cc_mqtt5::message::Suback<TBase, TOpt>,
+        cc_mqtt5::message::Unsuback<TBase, TOpt>,
+        cc_mqtt5::message::Pingresp<TBase, TOpt>,
+        cc_mqtt5::message::Disconnect<TBase, TOpt>,
+        cc_mqtt5::message::Auth<TBase, TOpt>
+    >;
+
+template <typename TBase, typename TOpt, typename TRecvPublishOpt>
 using Qos1ClientInputMessages =
     std::tuple<
         cc_mqtt5::message::Connack<TBase, TOpt>,
-        cc_mqtt5::message::Publish<TBase, TOpt>,
+        cc_mqtt5::message::Publish<TBase, TRecvPublishOpt>,
         cc_mqtt5::message::Puback<TBase, TOpt>,
         cc_mqtt5::message::Suback<TBase, TOpt>,
         cc_mqtt5::message::Unsuback<TBase, TOpt>,
@@ -51,11 +75,11 @@ using Qos1ClientInputMessages =
         cc_mqtt5::message::Auth<TBase, TOpt>
     >;
 
-template <typename TBase, typename TOpt>
+template <typename TBase, typename TOpt, typename TRecvPublishOpt>
 using Qos0ClientInputMessages =
     std::tuple<
         cc_mqtt5::message::Connack<TBase, TOpt>,
-        cc_mqtt5::message::Publish<TBase, TOpt>,
+        cc_mqtt5::message::Publish<TBase, TRecvPublishOpt>,
         cc_mqtt5::message::Suback<TBase, TOpt>,
         cc_mqtt5::message::Unsuback<TBase, TOpt>,
         cc_mqtt5::message::Pingresp<TBase, TOpt>,
@@ -66,11 +90,11 @@ using Qos0ClientInputMessages =
 using ProtInputMessages =
     std::conditional_t<
         2 <= Config::MaxQos,
-        cc_mqtt5::input::ClientInputMessages<ProtMessage, ProtocolOptions>,
+        Qos2ClientInputMessages<ProtMessage, ProtocolOptions, RecvPublishOptions>,
         std::conditional_t<
             1 == Config::MaxQos,
-            Qos1ClientInputMessages<ProtMessage, ProtocolOptions>,
-            Qos0ClientInputMessages<ProtMessage, ProtocolOptions>
+            Qos1ClientInputMessages<ProtMessage, ProtocolOptions, RecvPublishOptions>,
+            Qos0ClientInputMessages<ProtMessage, ProtocolOptions, RecvPublishOptions>
         >
     >;
 
@@ -0,0 +1,35 @@
+//
+// Copyright 2023 - 2026 (C). Alex Robenko. All rights reserved.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include "ProtocolDefs.h"
+
+#include "cc_mqtt5_client/common.h"
+
+#include <limits>
+
+namespace cc_mqtt5_client
+{
+
+struct PublishTemplate
+{
+    static constexpr unsigned NoPropIdx = std::numeric_limits<unsigned>::max();
+    using TopicStorageType = PublishMsg::Field_topic::ValueType;
+    using CorrelationDataStorageType = PublishMsg::Field_properties::ValueType::value_type::Field_correlationData::Field_value::ValueType;
+
+    PublishMsg m_pubMsg; // Validated message without topic alias and payload, patched in place during the send
+    TopicStorageType m_savedTopic; // Swapped with the topic when only the topic alias is sent
+    CorrelationDataStorageType m_savedCorrelationData; // Swapped with the correlation data replaced on send
+    CC_Mqtt5TopicAliasPreference m_topicAliasPref = CC_Mqtt5TopicAliasPreference_UseAliasIfAvailable;
+    unsigned m_propsCount = 0U; // Properties appended on send are removed afterwards
+    unsigned m_correlationDataIdx = NoPropIdx;
+    bool m_borrowData = false;
+    bool m_correlationDataReplaced = false;
+};
+
+} // namespace cc_mqtt5_client
@@ -0,0 +1,178 @@
+//
+// Copyright 2023 - 2026 (C). Alex Robenko. All rights reserved.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "ResponseTimeoutQueue.h"
+
+#include "comms/Assert.h"
+
+namespace cc_mqtt5_client
+{
+
+ResponseTimeoutQueue::ResponseTimeoutQueue(TimerMgr& timerMgr) :
+    m_timerMgr(timerMgr),
+    m_timer(timerMgr.allocTimer())
+{
+    COMMS_ASSERT(m_timer.isValid());
+}
+
+ResponseTimeoutQueue::~ResponseTimeoutQueue()
+{
+    COMMS_ASSERT(m_head == nullptr);
+}
+
+void ResponseTimeoutQueue::setSuspended(bool suspended)
+{
+    if (m_suspended == suspended) {
+        return;
+    }
+
+    // The deadlines are measured by the clock excluding the suspended periods
+    if (suspended) {
+        m_suspendTimestampMs = m_timerMgr.elapsedMs();
+        m_suspended = true;
+        m_timer.cancel();
+        return;
+    }
+
+    m_suspendedMs += m_timerMgr.elapsedMs() - m_suspendTimestampMs;
+    m_suspended = false;
+    programTimer();
+}
+
+std::uint64_t ResponseTimeoutQueue::nowMs() const
+{
+    auto now = m_suspended ? m_suspendTimestampMs : m_timerMgr.elapsedMs();
+    COMMS_ASSERT(m_suspendedMs <= now);
+    return now - m_suspendedMs;
+}
+
+void ResponseTimeoutQueue::timerWait(Timer& timer, unsigned timeoutMs, TimeoutCb cb, void* data)
+{
+    COMMS_ASSERT(cb != nullptr);
+    auto* prevHead = m_head;
+    if (timer.isActive()) {
+        unlink(timer);
+    }
+
+    timer.m_deadline = nowMs() + timeoutMs;
+    timer.m_timeoutCb = cb;
+    timer.m_timeoutData = data;
+
+    auto* prev = m_tail;
+    while ((prev != nullptr) && (timer.m_deadline < prev->m_deadline)) {
+        prev = prev->m_prev;
+    }
+
+    timer.m_prev = prev;
+    if (prev == nullptr) {
+        timer.m_next = m_head;
+        m_head = &timer;
+    }
+    else {
+        timer.m_next = prev->m_next;
+        prev->m_next = &timer;
+    }
+
+    if (timer.m_next == nullptr) {
+        m_tail = &timer;
+    }
+    else {
+        timer.m_next->m_prev = &timer;
+    }
+
+    if ((m_head != prevHead) || (m_head == &timer)) {
+        programTimer();
+    }
+}
+
+void ResponseTimeoutQueue::timerCancel(Timer& timer)
+{
+    if (!timer.isActive()) {
+        return;
+    }
+
+    bool wasHead = (m_head == &timer);
+    unlink(timer);
+    timer.m_deadline = 0U;
+    timer.m_timeoutCb = nullptr;
+    timer.m_timeoutData = nullptr;
+
+    if (wasHead) {
+        programTimer();
+    }
+}
+
+void ResponseTimeoutQueue::unlink(Timer& timer)
+{
+    if (timer.m_prev == nullptr) {
+        COMMS_ASSERT(m_head == &timer);
+        m_head = timer.m_next;
+    }
+    else {
+        timer.m_prev->m_next = timer.m_next;
+    }
+
+    if (timer.m_next == nullptr) {
+        COMMS_ASSERT(m_tail == &timer);
+        m_tail = timer.m_prev;
+    }
+    else {
+        timer.m_next->m_prev = timer.m_prev;
+    }
+
+    timer.m_prev = nullptr;
+    timer.m_next = nullptr;
+}
+
+void ResponseTimeoutQueue::programTimer()
+{
+    if (m_suspended || m_expiring) {
+        return;
+    }
+
+    if (m_head == nullptr) {
+        m_timer.cancel();
+        return;
+    }
+
+    auto now = nowMs();
+    auto deadline = m_head->m_deadline;
+    auto waitMs = (now < deadline) ? (deadline - now) : 0U;
+    m_timer.wait(waitMs, &ResponseTimeoutQueue::timeoutCb, this);
+}
+
+void ResponseTimeoutQueue::timeoutInternal()
+{
+    auto now = nowMs();
+
+    // The timers re-armed with zero timeout by the callbacks expire
+    // on the next tick.
+    auto count = 0U;
+    for (auto* timer = m_head; (timer != nullptr) && (timer->m_deadline <= now); timer = timer->m_next) {
+        ++count;
+    }
+
+    m_expiring = true;
+    while ((count > 0U) && (m_head != nullptr) && (m_head->m_deadline <= now)) {
+        --count;
+        auto& timer = *m_head;
+        auto cb = timer.m_timeoutCb;
+        auto* data = timer.m_timeoutData;
+        timerCancel(timer);
+        cb(data);
+    }
+
+    m_expiring = false;
+    programTimer();
+}
+
+void ResponseTimeoutQueue::timeoutCb(void* data)
+{
+    reinterpret_cast<ResponseTimeoutQueue*>(data)->timeoutInternal();
+}
+
+} // namespace cc_mqtt5_client
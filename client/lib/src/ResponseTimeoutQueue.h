@@ -0,0 +1,101 @@
+//
+// Copyright 2023 - 2026 (C). Alex Robenko. All rights reserved.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include "TimerMgr.h"
+
+#include <cstdint>
+
+namespace cc_mqtt5_client
+{
+
+// Intrusive list of the operations waiting for the response from broker
+// ordered by their deadlines and sharing single timer of the TimerMgr.
+// The timers using the same (default) timeout expire in FIFO order and
+// are appended to the end, the ones with custom timeout are inserted
+// in their place searching from the end.
+class ResponseTimeoutQueue
+{
+public:
+    using TimeoutCb = TimerMgr::TimeoutCb;
+
+    class Timer
+    {
+    public:
+        explicit Timer(ResponseTimeoutQueue& queue) :
+            m_queue(queue)
+        {
+        }
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+        ~Timer()
+        {
+            cancel();
+        }
+
+        void wait(unsigned timeoutMs, TimeoutCb cb, void* data)
+        {
+            m_queue.timerWait(*this, timeoutMs, cb, data);
+        }
+
+        void cancel()
+        {
+            m_queue.timerCancel(*this);
+        }
+
+        bool isActive() const
+        {
+            return m_timeoutCb != nullptr;
+        }
+
+    private:
+        ResponseTimeoutQueue& m_queue;
+        Timer* m_prev = nullptr;
+        Timer* m_next = nullptr;
+        std::uint64_t m_deadline = 0U;
+        TimeoutCb m_timeoutCb = nullptr;
+        void* m_timeoutData = nullptr;
+
+        friend class ResponseTimeoutQueue;
+    };
+
+    explicit ResponseTimeoutQueue(TimerMgr& timerMgr);
+    ~ResponseTimeoutQueue();
+
+    void setSuspended(bool suspended);
+
+    bool isSuspended() const
+    {
+        return m_suspended;
+    }
+
+private:
+    friend class Timer;
+
+    std::uint64_t nowMs() const;
+    void timerWait(Timer& timer, unsigned timeoutMs, TimeoutCb cb, void* data);
+    void timerCancel(Timer& timer);
+    void unlink(Timer& timer);
+    void programTimer();
+    void timeoutInternal();
+
+    static void timeoutCb(void* data);
+
+    TimerMgr& m_timerMgr;
+    TimerMgr::Timer m_timer;
+    Timer* m_head = nullptr;
+    Timer* m_tail = nullptr;
+    std::uint64_t m_suspendedMs = 0U; // Total time spent in the suspended state
+    std::uint64_t m_suspendTimestampMs = 0U;
+    bool m_suspended = false;
+    bool m_expiring = false;
+};
+
+} // namespace cc_mqtt5_client
@@ -10,7 +10,6 @@
 #include "comms/Assert.h"
 
 #include <algorithm>
-#include <iterator>
 #include <limits>
 
 namespace cc_mqtt5_client
@@ -21,28 +20,22 @@ TimerMgr::Timer TimerMgr::allocTimer()
     auto createTimer =
         [this](unsigned idx)
         {
-            m_timers[idx].m_allocated = true;
+            auto& info = m_timers[idx];
+            info.m_allocated = true;
+            info.m_link = NoIdx;
             ++m_allocatedTimers;
             return Timer(*this, idx);
         };
 
-    if (m_allocatedTimers < m_timers.size()) {
-        auto iter = std::find_if(
-            m_timers.begin(), m_timers.end(),
-            [](auto& info)
-            {
-                return !info.m_allocated;
-            });
-
-        if (iter != m_timers.end()) {
-            auto idx = static_cast<unsigned>(std::distance(m_timers.begin(), iter));
-            return createTimer(idx);
-        }
-
-        [[maybe_unused]] static constexpr bool Should_not_happen = false;
-        COMMS_ASSERT(Should_not_happen);
+    if (m_freeHead != NoIdx) {
+        COMMS_ASSERT(m_allocatedTimers < m_timers.size());
+        auto idx = m_freeHead;
+        COMMS_ASSERT(!m_timers[idx].m_allocated);
+        m_freeHead = m_timers[idx].m_link;
+        return createTimer(idx);
     }
 
+    COMMS_ASSERT(m_allocatedTimers == m_timers.size());
     if (m_timers.max_size() <= m_timers.size()) {
         return Timer(*this);
     }
@@ -58,28 +51,34 @@ void TimerMgr::tick(unsigned ms)
     {
         TimeoutCb m_timeoutCb = nullptr;
         void* m_timeoutData = nullptr;
+        unsigned m_idx = 0U;
     };
 
     using CbList = ObjListType<CbInfo, ExtConfig::TimersLimit>;
     CbList cbList;
 
-    for (auto idx = 0U; idx < m_timers.size(); ++idx) {
-        auto& info = m_timers[idx];
-        if ((!info.m_allocated) ||
-            (info.m_timeoutCb == nullptr) ||
-            (info.m_suspended)) {
-            continue;
-        }
+    m_elapsedMs += ms;
 
-        if (info.m_timeoutMs <= ms) {
-            cbList.push_back({info.m_timeoutCb, info.m_timeoutData});
-            timerCancel(idx);
-            continue;
+    while (!m_heap.empty()) {
+        auto idx = m_heap.front();
+        auto& info = m_timers[idx];
+        if (m_elapsedMs < info.m_expiryMs) {
+            break;
         }
 
-        info.m_timeoutMs -= ms;
+        cbList.push_back({info.m_timeoutCb, info.m_timeoutData, idx});
+        timerCancel(idx);
     }
 
+    // Invoke the callbacks in the order of the timers' slots regardless
+    // of their remaining timeouts.
+    std::sort(
+        cbList.begin(), cbList.end(),
+        [](auto& first, auto& second)
+        {
+            return first.m_idx < second.m_idx;
+        });
+
     for (auto& info : cbList) {
         info.m_timeoutCb(info.m_timeoutData);
     }
@@ -87,40 +86,19 @@ void TimerMgr::tick(unsigned ms)
 
 unsigned TimerMgr::getMinWait() const
 {
-    if (m_allocatedTimers == 0U) {
-        return 0U;
-    }
-
-    static constexpr auto Limit = std::numeric_limits<std::uint64_t>::max();
-    auto result = Limit;
-
-    for (auto& info : m_timers) {
-        if ((!info.m_allocated) ||
-            (info.m_timeoutCb == nullptr) ||
-            (info.m_suspended)) {
-            continue;
-        }
-
-        result = std::min(result, info.m_timeoutMs);
-    }
-
-    if (result == Limit) {
+    if (m_heap.empty()) {
         return 0U;
     }
 
+    auto deadline = m_timers[m_heap.front()].m_expiryMs;
+    COMMS_ASSERT(m_elapsedMs <= deadline);
+    auto result = deadline - m_elapsedMs;
     return static_cast<unsigned>(std::min(result, std::uint64_t(std::numeric_limits<unsigned>::max())));
 }
 
 unsigned TimerMgr::allocCount() const
 {
-    return
-        static_cast<unsigned>(
-            std::count_if(
-                m_timers.begin(), m_timers.end(),
-                [](auto& info)
-                {
-                    return info.m_allocated;
-                }));
+    return m_allocatedTimers;
 }
 
 void TimerMgr::freeTimer(unsigned idx)
@@ -133,7 +111,10 @@ void TimerMgr::freeTimer(unsigned idx)
     COMMS_ASSERT(m_allocatedTimers > 0U);
     auto& info = m_timers[idx];
     COMMS_ASSERT(info.m_allocated);
+    timerCancel(idx);
     info = TimerInfo();
+    info.m_link = m_freeHead;
+    m_freeHead = idx;
     --m_allocatedTimers;
 }
 
@@ -147,9 +128,20 @@ void TimerMgr::timerWait(unsigned idx, std::uint64_t timeoutMs, TimeoutCb cb, vo
     auto& info = m_timers[idx];
     COMMS_ASSERT(info.m_allocated);
     COMMS_ASSERT(cb != nullptr);
-    info.m_timeoutMs = timeoutMs;
+    if (info.m_link != NoIdx) {
+        heapRemove(idx);
+    }
+
     info.m_timeoutCb = cb;
     info.m_timeoutData = data;
+
+    if (info.m_suspended) {
+        info.m_expiryMs = timeoutMs;
+        return;
+    }
+
+    info.m_expiryMs = m_elapsedMs + timeoutMs;
+    heapPush(idx);
 }
 
 void TimerMgr::timerCancel(unsigned idx)
@@ -161,7 +153,11 @@ void TimerMgr::timerCancel(unsigned idx)
 
     auto& info = m_timers[idx];
     COMMS_ASSERT(info.m_allocated);
-    info.m_timeoutMs = 0;
+    if (info.m_link != NoIdx) {
+        heapRemove(idx);
+    }
+
+    info.m_expiryMs = 0;
     info.m_timeoutCb = nullptr;
     info.m_timeoutData = nullptr;
 }
@@ -175,7 +171,7 @@ bool TimerMgr::timerIsActive(unsigned idx) const
 
     auto& info = m_timers[idx];
     COMMS_ASSERT(info.m_allocated);
-    COMMS_ASSERT(info.m_timeoutCb != nullptr || (info.m_timeoutMs == 0U));
+    COMMS_ASSERT(info.m_timeoutCb != nullptr || (info.m_expiryMs == 0U));
     return (info.m_timeoutCb != nullptr);
 }
 
@@ -188,7 +184,25 @@ void TimerMgr::timerSetSuspended(unsigned idx, bool suspended)
 
     auto& info = m_timers[idx];
     COMMS_ASSERT(info.m_allocated);
+    if (info.m_suspended == suspended) {
+        return;
+    }
+
     info.m_suspended = suspended;
+    if (info.m_timeoutCb == nullptr) {
+        return;
+    }
+
+    // The suspended timer keeps its remaining timeout outside the heap
+    if (suspended) {
+        heapRemove(idx);
+        COMMS_ASSERT(m_elapsedMs <= info.m_expiryMs);
+        info.m_expiryMs -= m_elapsedMs;
+        return;
+    }
+
+    info.m_expiryMs += m_elapsedMs;
+    heapPush(idx);
 }
 
 bool TimerMgr::timerIsSuspended(unsigned idx) const
@@ -203,4 +217,87 @@ bool TimerMgr::timerIsSuspended(unsigned idx) const
     return info.m_suspended;
 }
 
+bool TimerMgr::isEarlier(unsigned first, unsigned second) const
+{
+    return m_timers[first].m_expiryMs < m_timers[second].m_expiryMs;
+}
+
+void TimerMgr::heapPush(unsigned idx)
+{
+    COMMS_ASSERT(m_timers[idx].m_link == NoIdx);
+    COMMS_ASSERT(m_heap.size() < m_heap.max_size());
+    auto pos = static_cast<unsigned>(m_heap.size());
+    m_heap.push_back(idx);
+    m_timers[idx].m_link = pos;
+    heapSiftUp(pos);
+}
+
+void TimerMgr::heapRemove(unsigned idx)
+{
+    auto pos = m_timers[idx].m_link;
+    COMMS_ASSERT(pos < m_heap.size());
+    COMMS_ASSERT(m_heap[pos] == idx);
+    m_timers[idx].m_link = NoIdx;
+
+    auto lastIdx = m_heap.back();
+    m_heap.pop_back();
+    if (m_heap.size() <= pos) {
+        return;
+    }
+
+    heapSet(pos, lastIdx);
+    heapSiftUp(pos);
+    heapSiftDown(m_timers[lastIdx].m_link);
+}
+
+void TimerMgr::heapSet(unsigned pos, unsigned idx)
+{
+    m_heap[pos] = idx;
+    m_timers[idx].m_link = pos;
+}
+
+void TimerMgr::heapSiftUp(unsigned pos)
+{
+    auto idx = m_heap[pos];
+    while (pos > 0U) {
+        auto parentPos = (pos - 1U) / 2U;
+        auto parentIdx = m_heap[parentPos];
+        if (!isEarlier(idx, parentIdx)) {
+            break;
+        }
+
+        heapSet(pos, parentIdx);
+        pos = parentPos;
+    }
+
+    heapSet(pos, idx);
+}
+
+void TimerMgr::heapSiftDown(unsigned pos)
+{
+    auto idx = m_heap[pos];
+    auto count = static_cast<unsigned>(m_heap.size());
+    while (true) {
+        auto childPos = (pos * 2U) + 1U;
+        if (count <= childPos) {
+            break;
+        }
+
+        auto rightPos = childPos + 1U;
+        if ((rightPos < count) && isEarlier(m_heap[rightPos], m_heap[childPos])) {
+            childPos = rightPos;
+        }
+
+        auto childIdx = m_heap[childPos];
+        if (!isEarlier(childIdx, idx)) {
+            break;
+        }
+
+        heapSet(pos, childIdx);
+        pos = childPos;
+    }
+
+    heapSet(pos, idx);
+}
+
 } // namespace cc_mqtt5_client
@@ -13,6 +13,7 @@
 #include "comms/util/StaticVector.h"
 #include "comms/util/type_traits.h"
 
+#include <cstdint>
 #include <limits>
 
 namespace cc_mqtt5_client
@@ -96,17 +97,26 @@ public:
     unsigned getMinWait() const;
     unsigned allocCount() const;
 
+    std::uint64_t elapsedMs() const
+    {
+        return m_elapsedMs;
+    }
+
 private:
+    static const unsigned NoIdx = Timer::InvalidIdx;
+
     struct TimerInfo
     {
-        std::uint64_t m_timeoutMs = 0U;
+        std::uint64_t m_expiryMs = 0U; // Absolute deadline when waiting, remaining timeout when suspended
         TimeoutCb m_timeoutCb = nullptr;
         void* m_timeoutData = nullptr;
+        unsigned m_link = NoIdx; // Position in the heap when waiting or next free slot when not allocated
         bool m_allocated = false;
         bool m_suspended = false;
     };
 
     using StorageType = ObjListType<TimerInfo, ExtConfig::TimersLimit>;
+    using HeapType = ObjListType<unsigned, ExtConfig::TimersLimit>;
 
     friend class Timer;
 
@@ -116,9 +126,18 @@ private:
     bool timerIsActive(unsigned idx) const;
     void timerSetSuspended(unsigned idx, bool suspended);
     bool timerIsSuspended(unsigned idx) const;
+    bool isEarlier(unsigned first, unsigned second) const;
+    void heapPush(unsigned idx);
+    void heapRemove(unsigned idx);
+    void heapSet(unsigned pos, unsigned idx);
+    void heapSiftUp(unsigned pos);
+    void heapSiftDown(unsigned pos);
 
     StorageType m_timers;
+    HeapType m_heap; // Indices of the waiting (not suspended) timers, the earliest deadline first
+    unsigned m_freeHead = NoIdx; // List of the released slots
     unsigned m_allocatedTimers = 0U;
+    std::uint64_t m_elapsedMs = 0U; // Monotonic clock advanced by the tick() invocations
 };
 
 } // namespace cc_mqtt5_client
@@ -28,7 +28,9 @@ KeepAliveOp::KeepAliveOp(ClientImpl& client) :
     Base(client),
     m_pingTimer(client.timerMgr().allocTimer()),
     m_recvTimer(client.timerMgr().allocTimer()),
-    m_respTimer(client.timerMgr().allocTimer())
+    m_respTimer(client.timerMgr().allocTimer()),
+    m_lastSendMs(client.timerMgr().elapsedMs()),
+    m_lastRecvMs(client.timerMgr().elapsedMs())
 {
     COMMS_ASSERT(m_pingTimer.isValid());
     COMMS_ASSERT(m_recvTimer.isValid());
@@ -39,14 +41,19 @@ KeepAliveOp::KeepAliveOp(ClientImpl& client) :
 
 void KeepAliveOp::messageSent()
 {
-    restartPingTimer();
+    // The timer is not reprogrammed on every sent message,
+    // the time of the last one is checked on expiry.
+    m_lastSendMs = client().timerMgr().elapsedMs();
+    if (!m_pingTimer.isActive()) {
+        restartPingTimer();
+    }
 }
 
 void KeepAliveOp::handle([[maybe_unused]] PingrespMsg& msg)
 {
     m_respTimer.cancel();
     COMMS_ASSERT(!m_respTimer.isActive());
-    restartRecvTimer();
+    messageReceived();
 }
 
 void KeepAliveOp::handle(DisconnectMsg& msg)
@@ -98,7 +105,7 @@ void KeepAliveOp::handle(DisconnectMsg& msg)
 
 void KeepAliveOp::handle([[maybe_unused]] ProtMessage& msg)
 {
-    restartRecvTimer();
+    messageReceived();
 }
 
 Op::Type KeepAliveOp::typeImpl() const
@@ -126,6 +133,42 @@ void KeepAliveOp::restartRecvTimer()
     m_recvTimer.wait(state.m_keepAliveMs, &KeepAliveOp::recvTimeoutCb, this);
 }
 
+void KeepAliveOp::messageReceived()
+{
+    m_lastRecvMs = client().timerMgr().elapsedMs();
+    if (!m_recvTimer.isActive()) {
+        restartRecvTimer();
+    }
+}
+
+void KeepAliveOp::pingTimerExpiredInternal()
+{
+    auto& state = client().sessionState();
+    auto dueMs = m_lastSendMs + state.m_keepAliveMs;
+    auto now = client().timerMgr().elapsedMs();
+    if (now < dueMs) {
+        // Other messages have been sent in the meantime
+        m_pingTimer.wait(dueMs - now, &KeepAliveOp::sendPingCb, this);
+        return;
+    }
+
+    sendPing();
+}
+
+void KeepAliveOp::recvTimerExpiredInternal()
+{
+    auto& state = client().sessionState();
+    auto dueMs = m_lastRecvMs + state.m_keepAliveMs;
+    auto now = client().timerMgr().elapsedMs();
+    if (now < dueMs) {
+        // Other messages have been received in the meantime
+        m_recvTimer.wait(dueMs - now, &KeepAliveOp::recvTimeoutCb, this);
+        return;
+    }
+
+    sendPing();
+}
+
 void KeepAliveOp::sendPing()
 {
     if (m_respTimer.isActive()) {
@@ -133,7 +176,7 @@ void KeepAliveOp::sendPing()
     }
 
     PingreqMsg msg;
-    client().sendMessage(msg);
+    client().sendUncorkedMessage(msg); // The response timer starts now, cannot be held
     auto& state = client().configState();
     m_respTimer.wait(state.m_responseTimeoutMs, &KeepAliveOp::pingTimeoutCb, this);
 }
@@ -148,12 +191,12 @@ void KeepAliveOp::pingTimeoutInternal()
 
 void KeepAliveOp::sendPingCb(void* data)
 {
-    asKeepAliveOp(data)->sendPing();
+    asKeepAliveOp(data)->pingTimerExpiredInternal();
 }
 
 void KeepAliveOp::recvTimeoutCb(void* data)
 {
-    asKeepAliveOp(data)->sendPing();
+    asKeepAliveOp(data)->recvTimerExpiredInternal();
 }
 
 void KeepAliveOp::pingTimeoutCb(void* data)
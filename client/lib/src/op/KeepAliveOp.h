@@ -13,6 +13,8 @@
 
 #include "TimerMgr.h"
 
+#include <cstdint>
+
 namespace cc_mqtt5_client
 {
 
@@ -38,6 +40,9 @@ protected:
 private:
     void restartPingTimer();
     void restartRecvTimer();
+    void messageReceived();
+    void pingTimerExpiredInternal();
+    void recvTimerExpiredInternal();
     void sendPing();
     void pingTimeoutInternal();
 
@@ -48,6 +53,8 @@ private:
     TimerMgr::Timer m_pingTimer;
     TimerMgr::Timer m_recvTimer;
     TimerMgr::Timer m_respTimer;
+    std::uint64_t m_lastSendMs = 0U;
+    std::uint64_t m_lastRecvMs = 0U;
 
     static_assert(ExtConfig::KeepAliveOpTimers == 3U);
 };
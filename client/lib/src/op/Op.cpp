@@ -53,44 +53,22 @@ void Op::connectivityChangedImpl()
 
 void Op::opComplete()
 {
+    if (isTransient()) {
+        // Stateless handling, not registered in the client
+        return;
+    }
+
     m_client.opComplete(this);
 }
 
 std::uint16_t Op::allocPacketId()
 {
-    static constexpr auto MaxPacketId = std::numeric_limits<std::uint16_t>::max();
-    auto& allocatedPacketIds = m_client.clientState().m_allocatedPacketIds;
-
-    if ((allocatedPacketIds.max_size() <= allocatedPacketIds.size()) ||
-        (MaxPacketId <= allocatedPacketIds.size())) {
+    auto packetId = m_client.clientState().m_packetIdsAlloc.alloc();
+    if (packetId == 0U) {
         errorLog("No more available packet IDs for allocation");
-        return 0U;
-    }
-
-    auto& lastPacketId = m_client.clientState().m_lastPacketId;
-    auto nextPacketId = static_cast<std::uint16_t>(lastPacketId + 1U);
-
-    if (nextPacketId == 0U) {
-        nextPacketId = 1U;
-    }
-
-    while (true) {
-        if (allocatedPacketIds.empty() || (allocatedPacketIds.back() < nextPacketId)) {
-            allocatedPacketIds.push_back(nextPacketId);
-            break;
-        }
-
-        auto iter = std::lower_bound(allocatedPacketIds.begin(), allocatedPacketIds.end(), nextPacketId);
-        if ((iter == allocatedPacketIds.end()) || (*iter != nextPacketId)) {
-            allocatedPacketIds.insert(iter, nextPacketId);
-            break;
-        }
-
-        ++nextPacketId;
     }
 
-    lastPacketId = static_cast<std::uint16_t>(nextPacketId);
-    return lastPacketId;
+    return packetId;
 }
 
 void Op::releasePacketId(std::uint16_t id)
@@ -99,15 +77,8 @@ void Op::releasePacketId(std::uint16_t id)
         return;
     }
 
-    auto& allocatedPacketIds = m_client.clientState().m_allocatedPacketIds;
-    auto iter = std::lower_bound(allocatedPacketIds.begin(), allocatedPacketIds.end(), id);
-    if ((iter == allocatedPacketIds.end()) || (*iter != id)) {
-        [[maybe_unused]] static constexpr bool ShouldNotHappen = false;
-        COMMS_ASSERT(ShouldNotHappen);
-        return;
-    }
-
-    allocatedPacketIds.erase(iter);
+    [[maybe_unused]] auto released = m_client.clientState().m_packetIdsAlloc.release(id);
+    COMMS_ASSERT(released);
 }
 
 void Op::sendDisconnectWithReason(ClientImpl& client, DisconnectReason reason)
@@ -149,24 +120,6 @@ void Op::protocolErrorTermination()
     protocolErrorTermination(m_client);
 }
 
-void Op::fillUserProps(const PropsHandler& propsHandler, UserPropsList& userProps)
-{
-    if constexpr (Config::HasUserProps) {
-        userProps.reserve(std::min(propsHandler.m_userProps.size() + userProps.size(), userProps.max_size()));
-        auto endIter = propsHandler.m_userProps.end();
-        if constexpr (Config::UserPropsLimit > 0U) {
-            endIter = propsHandler.m_userProps.begin() + std::min(propsHandler.m_userProps.size(), std::size_t(Config::UserPropsLimit));
-        }
-
-        std::transform(
-            propsHandler.m_userProps.begin(), endIter, std::back_inserter(userProps),
-            [](auto* field)
-            {
-                return UserPropsList::value_type{field->field_value().field_first().value().c_str(), field->field_value().field_second().value().c_str()};
-            });
-    }
-}
-
 bool Op::isSharedTopicFilter(const char* filter)
 {
     static const char SharePrefix[] = {'$', 's', 'h', 'a', 'r', 'e', '/' };
@@ -185,6 +138,11 @@ bool Op::isSharedTopicFilter(const char* filter)
     return true;
 }
 
+bool Op::isLazyProps() const
+{
+    return m_client.configState().m_lazyProps;
+}
+
 void Op::errorLogInternal(const char* msg)
 {
     if constexpr (Config::HasErrorLog) {
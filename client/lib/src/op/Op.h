@@ -14,6 +14,8 @@
 
 #include "cc_mqtt5_client/common.h"
 
+#include <algorithm>
+#include <iterator>
 #include <limits>
 
 namespace cc_mqtt5_client
@@ -41,6 +43,23 @@ public:
     };
 
     using Qos = PublishMsg::TransportField_flags::Field_qos::ValueType;
+    using UserPropsList = ObjListType<CC_Mqtt5UserProp, Config::UserPropsLimit, Config::HasUserProps>;
+    using LazyUserPropsFillFunc = void (*)(const void* props, UserPropsList& userProps);
+    using SubIdsStorage = ObjListType<unsigned, Config::SubIdsLimit, Config::HasSubIds>;
+    using DisconnectReason = DisconnectMsg::Field_reasonCode::Field::ValueType;
+
+    // Not yet decoded user properties of the reported message
+    struct LazyUserProps
+    {
+        const void* m_src = nullptr;
+        LazyUserPropsFillFunc m_fillFunc = nullptr; // Reset after decoding
+        UserPropsList* m_userProps = nullptr; // Storage of the decoded properties
+
+        CC_Mqtt5LazyUserPropsHandle toHandle()
+        {
+            return reinterpret_cast<CC_Mqtt5LazyUserPropsHandle>(this);
+        }
+    };
 
     virtual ~Op() noexcept = default;
 
@@ -69,16 +88,30 @@ public:
         connectivityChangedImpl();
     }
 
+    unsigned opsIdx() const
+    {
+        return m_opsIdx;
+    }
+
+    void setOpsIdx(unsigned idx)
+    {
+        m_opsIdx = idx;
+    }
+
+    bool isTransient() const
+    {
+        return m_opsIdx == TransientOpsIdx;
+    }
+
     inline
     static bool verifyQosValid(Qos qos)
     {
         return (qos <= static_cast<decltype(qos)>(Config::MaxQos));
     }
 
-protected:
-    using UserPropsList = ObjListType<CC_Mqtt5UserProp, Config::UserPropsLimit, Config::HasUserProps>;
-    using DisconnectReason = DisconnectMsg::Field_reasonCode::Field::ValueType;
+    static void terminationWithReasonStatic(ClientImpl& client, DisconnectReason reason);
 
+protected:
     explicit Op(ClientImpl& client);
 
     virtual Type typeImpl() const = 0;
@@ -102,7 +135,6 @@ protected:
 
     static void sendDisconnectWithReason(ClientImpl& client, DisconnectReason reason);
     void sendDisconnectWithReason(DisconnectReason reason);
-    static void terminationWithReasonStatic(ClientImpl& client, DisconnectReason reason);
     void terminationWithReason(DisconnectReason reason);
     static void protocolErrorTermination(ClientImpl& client);
     void protocolErrorTermination();
@@ -133,7 +165,45 @@ protected:
         }
     }
 
-    static void fillUserProps(const PropsHandler& propsHandler, UserPropsList& userProps);
+    template <typename TPropsHandler>
+    static void fillUserProps(const TPropsHandler& propsHandler, UserPropsList& userProps)
+    {
+        if constexpr (Config::HasUserProps) {
+            userProps.reserve(std::min(propsHandler.m_userProps.size() + userProps.size(), userProps.max_size()));
+            auto endIter = propsHandler.m_userProps.end();
+            if constexpr (Config::UserPropsLimit > 0U) {
+                endIter = propsHandler.m_userProps.begin() + std::min(propsHandler.m_userProps.size(), std::size_t(Config::UserPropsLimit));
+            }
+
+            std::transform(
+                propsHandler.m_userProps.begin(), endIter, std::back_inserter(userProps),
+                [](auto* field)
+                {
+                    return UserPropsList::value_type{field->field_value().field_first().value().c_str(), field->field_value().field_second().value().c_str()};
+                });
+        }
+    }
+
+    template <typename TPropsHandler, typename TPropsList>
+    static void fillLazyUserProps(const void* props, UserPropsList& userProps)
+    {
+        TPropsHandler propsHandler;
+        for (auto& p : *reinterpret_cast<const TPropsList*>(props)) {
+            p.currentFieldExec(propsHandler);
+        }
+
+        fillUserProps(propsHandler, userProps);
+    }
+
+    template <typename TPropsHandler, typename TPropsList>
+    static void setLazyUserProps(const TPropsList& props, UserPropsList& userProps, LazyUserProps& lazyProps)
+    {
+        lazyProps.m_src = &props;
+        lazyProps.m_fillFunc = &Op::fillLazyUserProps<TPropsHandler, TPropsList>;
+        lazyProps.m_userProps = &userProps;
+    }
+
+    bool isLazyProps() const;
 
     template <typename TField>
     static bool canAddProp(const TField& field)
@@ -211,8 +281,11 @@ private:
     bool verifySubFilterInternal(const char* filter);
     bool verifyPubTopicInternal(const char* topic, bool outgoing);
 
+    static constexpr unsigned TransientOpsIdx = std::numeric_limits<unsigned>::max();
+
     ClientImpl& m_client;
     unsigned m_responseTimeoutMs = 0U;
+    unsigned m_opsIdx = TransientOpsIdx; // Index in the client's list of all the ops, transient ops are never added
 };
 
 } // namespace op
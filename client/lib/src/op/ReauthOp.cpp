@@ -34,7 +34,7 @@ inline ReauthOp* asReauthOp(void* data)
 
 ReauthOp::ReauthOp(ClientImpl& client) :
     Base(client),
-    m_timer(client.timerMgr().allocTimer())
+    m_timer(client.responseTimeouts())
 {
 }
 
@@ -124,11 +124,6 @@ CC_Mqtt5ErrorCode ReauthOp::send(CC_Mqtt5ReauthCompleteCb cb, void* cbData)
         return CC_Mqtt5ErrorCode_BadParam;
     }
 
-    if (!m_timer.isValid()) {
-        errorLog("The library cannot allocate required number of timers.");
-        return CC_Mqtt5ErrorCode_InternalError;
-    }
-
     if (m_authCb == nullptr) {
         errorLog("Authentication hasn't been configred.");
         return CC_Mqtt5ErrorCode_InsufficientConfig;
@@ -12,7 +12,7 @@
 #include "PropsHandler.h"
 #include "ProtocolDefs.h"
 
-#include "TimerMgr.h"
+#include "ResponseTimeoutQueue.h"
 
 namespace cc_mqtt5_client
 {
@@ -48,13 +48,13 @@ private:
     static void opTimeoutCb(void* data);
 
     AuthMsg m_authMsg;
-    TimerMgr::Timer m_timer;
+    ResponseTimeoutQueue::Timer m_timer;
     CC_Mqtt5ReauthCompleteCb m_cb = nullptr;
     void* m_cbData = nullptr;
     CC_Mqtt5AuthCb m_authCb = nullptr;
     void* m_authCbData = nullptr;
 
-    static_assert(ExtConfig::ReauthOpTimers == 1U);
+    static_assert(ExtConfig::ReauthOpTimers == 0U);
 };
 
 } // namespace op
@@ -19,10 +19,7 @@ namespace op
 namespace
 {
 
-inline RecvOp* asRecvOp(void* data)
-{
-    return reinterpret_cast<RecvOp*>(data);
-}
+using RecvPublishPropsHandler = BasicPropsHandler<RecvPublishOptions>;
 
 bool isTopicMatch(std::string_view filter, std::string_view topic)
 {
@@ -85,13 +82,11 @@ bool isTopicMatch(const TopicFilterStr& filter, const TopicStr& topic)
 } // namespace
 
 RecvOp::RecvOp(ClientImpl& client) :
-    Base(client),
-    m_responseTimer(client.timerMgr().allocTimer())
+    Base(client)
 {
-    COMMS_ASSERT(m_responseTimer.isValid());
 }
 
-void RecvOp::handle(PublishMsg& msg)
+void RecvOp::handle(RecvPublishMsg& msg)
 {
     auto qos = msg.transportField_flags().field_qos().value();
 
@@ -107,26 +102,6 @@ void RecvOp::handle(PublishMsg& msg)
         return;
     }
 
-    if constexpr (Config::MaxQos >= 2) {
-        if ((qos == Qos::ExactlyOnceDelivery) &&
-            (m_packetId != 0U) &&
-            (msg.field_packetId().doesExist())) {
-
-            if (msg.field_packetId().field().value() != m_packetId) {
-                // Applicable to other RecvOp being handled in parallel
-                return;
-            }
-
-            // If dispatched to this op, duplicate has been detected
-            COMMS_ASSERT(msg.transportField_flags().field_dup().getBitValue_bit());
-            PubrecMsg pubrecMsg;
-            pubrecMsg.field_packetId().setValue(m_packetId);
-            sendMessage(pubrecMsg);
-            restartResponseTimer();
-            return;
-        }
-    }
-
     auto& sessionState = client().sessionState();
 
     if constexpr (Config::MaxQos >= 1) {
@@ -188,9 +163,11 @@ void RecvOp::handle(PublishMsg& msg)
     }
 
     UserPropsList userProps;
+    LazyUserProps lazyUserProps;
     SubIdsStorage subIds;
 
-    PropsHandler propsHandler;
+    RecvPublishPropsHandler propsHandler;
+    propsHandler.m_lazyUserProps = isLazyProps();
     for (auto& p : msg.field_properties().value()) {
         p.currentFieldExec(propsHandler);
     }
@@ -281,7 +258,14 @@ void RecvOp::handle(PublishMsg& msg)
     }
 
     if constexpr (Config::HasUserProps) {
-        if (!propsHandler.m_userProps.empty()) {
+        if (propsHandler.m_hasLazyUserProps) {
+            setLazyUserProps<RecvPublishPropsHandler>(msg.field_properties().value(), userProps, lazyUserProps);
+            if (!client().isMsgsBatchEnabled()) {
+                // The batched messages receive the handle when reported
+                info.m_lazyUserProps = lazyUserProps.toHandle();
+            }
+        }
+        else if (!propsHandler.m_userProps.empty()) {
             fillUserProps(propsHandler, userProps);
             comms::cast_assign(info.m_userPropsCount) = userProps.size();
             info.m_userProps = &userProps[0];
@@ -317,6 +301,42 @@ void RecvOp::handle(PublishMsg& msg)
 
     info.m_retained = msg.transportField_flags().field_retain().getBitValue_bit();
 
+    if (client().isMsgsBatchEnabled()) {
+        unsigned packetId = 0U;
+        if (qos > Qos::AtMostOnceDelivery) {
+            if (!msg.field_packetId().doesExist()) {
+                [[maybe_unused]] static constexpr bool ProtocolDecodingError = false;
+                COMMS_ASSERT(ProtocolDecodingError);
+                terminationWithReason(DisconnectReason::UnspecifiedError);
+                return;
+            }
+
+            packetId = msg.field_packetId().field().value();
+        }
+
+        const TopicStr* aliasTopic = nullptr;
+        if (topicPtr != &topic) {
+            aliasTopic = topicPtr;
+        }
+
+        // The acknowledgement is sent by the client after the whole batch is reported
+        client().batchMsgInfo(info, userProps, lazyUserProps, subIds, aliasTopic, packetId);
+
+        if constexpr (Config::MaxQos >= 2) {
+            if ((qos == Qos::ExactlyOnceDelivery) &&
+                (!client().addPendingRecvQos2(static_cast<std::uint16_t>(packetId)))) {
+                errorLog("Failed to record the incoming QoS2 PUBLISH message.");
+                auto& cl = client();
+                opComplete(); // No member access after this point
+                terminationWithReasonStatic(cl, DisconnectReason::ReceiveMaxExceeded);
+                return;
+            }
+        }
+
+        opComplete();
+        return;
+    }
+
     if (qos == Qos::AtMostOnceDelivery) {
         client().reportMsgInfo(info);
         opComplete();
@@ -343,86 +363,19 @@ void RecvOp::handle(PublishMsg& msg)
     }
 
     if constexpr (Config::MaxQos >= 2) {
-        m_packetId = msg.field_packetId().field().value();
-        PubrecMsg pubrecMsg;
-        pubrecMsg.field_packetId().setValue(m_packetId);
-        sendMessage(pubrecMsg);
-        restartResponseTimer();
-    }
-}
-
-#if CC_MQTT5_CLIENT_MAX_QOS >= 2
-void RecvOp::handle(PubrelMsg& msg)
-{
-    static_assert(Config::MaxQos >= 2);
-    if (msg.field_packetId().value() != m_packetId) {
-        return;
-    }
-
-    m_responseTimer.cancel();
-
-    if (!msg.doValid()) {
-        errorLog("Received invalid flags in PUBREL message");
-        terminationWithReason(DisconnectReason::MalformedPacket);
-        return;
-    }
-
-    if (msg.field_properties().doesExist()) {
-        PropsHandler propsHandler;
-        for (auto& p : msg.field_properties().field().value()) {
-            p.currentFieldExec(propsHandler);
-        }
-
-        if (propsHandler.m_reasonStr != nullptr) {
-            if (!client().sessionState().m_problemInfoAllowed) {
-                errorLog("Received reason string in PUBREL when \"problem information\" was disabled in CONNECT.");
-                protocolErrorTermination();
-                return;
-            }
-
-            errorLog("PUBREL reason info:");
-            errorLog(propsHandler.m_reasonStr->field_value().value().c_str());
-        }
-
-        if constexpr (Config::HasUserProps) {
-            if (!propsHandler.m_userProps.empty()) {
-                if (!client().sessionState().m_problemInfoAllowed) {
-                    errorLog("Received user properties in PUBREL when \"problem information\" was disabled in CONNECT.");
-                    protocolErrorTermination();
-                    return;
-                }
-
-                // User properties in PUBREL are ignored
-            }
+        auto packetId = msg.field_packetId().field().value();
+        if (!client().addPendingRecvQos2(packetId)) {
+            errorLog("Failed to record the incoming QoS2 PUBLISH message.");
+            auto& cl = client();
+            opComplete(); // No member access after this point
+            terminationWithReasonStatic(cl, DisconnectReason::ReceiveMaxExceeded);
+            return;
         }
-    }
 
-    if ((msg.field_reasonCode().doesExist()) &&
-        (msg.field_reasonCode().field().value() != PubrelMsg::Field_reasonCode::Field::ValueType::Success)) {
-        errorLog("Publish reception terminated due to error reason code in PUBREL message.");
+        PubrecMsg pubrecMsg;
+        pubrecMsg.field_packetId().setValue(packetId);
+        sendMessage(pubrecMsg);
         opComplete();
-        return;
-    }
-
-    PubcompMsg pubcompMsg;
-    pubcompMsg.field_packetId().setValue(m_packetId);
-    sendMessage(pubcompMsg);
-    opComplete();
-}
-#endif // #if CC_MQTT5_CLIENT_MAX_QOS >= 2
-
-void RecvOp::resetTimer()
-{
-    if constexpr (Config::MaxQos >= 2) {
-        m_responseTimer.cancel();
-    }
-}
-
-void RecvOp::postReconnectionResume()
-{
-    if constexpr (Config::MaxQos >= 2) {
-        connectivityChangedImpl();
-        restartResponseTimer();
     }
 }
 
@@ -431,40 +384,6 @@ Op::Type RecvOp::typeImpl() const
     return Type_Recv;
 }
 
-void RecvOp::connectivityChangedImpl()
-{
-    if constexpr (Config::MaxQos >= 2) {
-        m_responseTimer.setSuspended(
-            (!client().sessionState().m_connected) || client().clientState().m_networkDisconnected);
-    }
-}
-
-void RecvOp::restartResponseTimer()
-{
-    if constexpr (Config::MaxQos >= 2) {
-        auto& state = client().configState();
-        m_responseTimer.wait(state.m_responseTimeoutMs, &RecvOp::recvTimeoutCb, this);
-    }
-}
-
-void RecvOp::responseTimeoutInternal()
-{
-    if constexpr (Config::MaxQos >= 2) {
-        // When there is no response from broker, just terminate the reception.
-        // The retry will be initiated by the broker.
-        COMMS_ASSERT(!m_responseTimer.isActive());
-        errorLog("Timeout on PUBREL reception from broker.");
-        opComplete();
-    }
-}
-
-void RecvOp::recvTimeoutCb(void* data)
-{
-    if constexpr (Config::MaxQos >= 2) {
-        asRecvOp(data)->responseTimeoutInternal();
-    }
-}
-
 } // namespace op
 
 } // namespace cc_mqtt5_client
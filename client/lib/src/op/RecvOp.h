@@ -12,8 +12,6 @@
 #include "ProtocolDefs.h"
 #include "TopicAliasDefs.h"
 
-#include "TimerMgr.h"
-
 namespace cc_mqtt5_client
 {
 
@@ -27,36 +25,14 @@ public:
     explicit RecvOp(ClientImpl& client);
 
     using Base::handle;
-    void handle(PublishMsg& msg) override;
-
-#if CC_MQTT5_CLIENT_MAX_QOS >= 2
-    void handle(PubrelMsg& msg) override;
-#endif // #if CC_MQTT5_CLIENT_MAX_QOS >= 2
-
-    unsigned packetId() const
-    {
-        return m_packetId;
-    }
-
-    void resetTimer();
-    void postReconnectionResume();
+    void handle(RecvPublishMsg& msg) override;
 
 protected:
     virtual Type typeImpl() const override;
-    virtual void connectivityChangedImpl() override;
 
 private:
-    using SubIdsStorage = ObjListType<unsigned, Config::SubIdsLimit, Config::HasSubIds>;
-
-    void restartResponseTimer();
-    void responseTimeoutInternal();
-
-    static void recvTimeoutCb(void* data);
-
-    TimerMgr::Timer m_responseTimer;
-    unsigned m_packetId = 0U;
-
-    static_assert(ExtConfig::RecvOpTimers == 1U);
+    // The QoS2 reception waiting for PUBREL is tracked by the client
+    static_assert(ExtConfig::RecvOpTimers == 0U);
 };
 
 } // namespace op
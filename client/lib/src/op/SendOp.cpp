@@ -10,6 +10,8 @@
 
 #include "comms/units.h"
 
+#include <type_traits>
+
 namespace cc_mqtt5_client
 {
 
@@ -24,26 +26,61 @@ inline SendOp* asSendOp(void* data)
     return reinterpret_cast<SendOp*>(data);
 }
 
+static constexpr bool IsPayloadRecyclable = std::is_same_v<PublishMsg::Field_payload::ValueType, SendOp::EncodedMsgBuf>;
+
+template <typename TBuf>
+void acquireRecycledBuf(TBuf& buf, SendOp::RecycledBufsList& bufs)
+{
+    // Reuse the allocated capacity of the completed ops' buffers
+    if (bufs.empty()) {
+        return;
+    }
+
+    COMMS_ASSERT(buf.empty());
+    buf.swap(bufs.back());
+    bufs.pop_back();
+}
+
+template <typename TBuf>
+void releaseRecycledBuf(TBuf& buf, SendOp::RecycledBufsList& bufs)
+{
+    // Up to two buffers per recycled op
+    if ((buf.capacity() == 0U) || ((ExtConfig::RecycledObjsLimit * 2U) <= bufs.size())) {
+        return;
+    }
+
+    buf.clear();
+    bufs.emplace_back();
+    bufs.back().swap(buf);
+}
+
 } // namespace
 
-SendOp::SendOp(ClientImpl& client) :
+SendOp::SendOp(ClientImpl& client, PublishMsg* msg) :
     Base(client),
-    m_responseTimer(client.timerMgr().allocTimer())
+    m_responseTimer(client.responseTimeouts()),
+    m_msg(msg)
 {
-    COMMS_ASSERT(m_responseTimer.isValid());
+    if (m_msg == nullptr) {
+        m_pubMsg = client.allocPubMsg();
+        m_msg = m_pubMsg.get();
+    }
+
+    COMMS_ASSERT(m_msg != nullptr);
     static_cast<void>(m_reasonCode);
 }
 
 SendOp::~SendOp()
 {
-    releasePacketId(m_pubMsg.field_packetId().field().value());
+    releaseTemplate(false);
+    releasePacketId(m_packetId);
 }
 
 #if CC_MQTT5_CLIENT_MAX_QOS >= 1
 void SendOp::handle(PubackMsg& msg)
 {
     static_assert(Config::MaxQos >= 1);
-    COMMS_ASSERT(m_pubMsg.field_packetId().field().value() == msg.field_packetId().value());
+    COMMS_ASSERT(m_packetId == msg.field_packetId().value());
     COMMS_ASSERT(m_published);
     COMMS_ASSERT(0U < client().clientState().m_inFlightSends);
 
@@ -58,6 +95,7 @@ void SendOp::handle(PubackMsg& msg)
 
     auto status = CC_Mqtt5AsyncOpStatus_ProtocolError;
     UserPropsList userProps; // Will be referenced in response
+    LazyUserProps lazyUserProps; // Will be referenced in response
     auto response = CC_Mqtt5PublishResponse();
 
     auto completeOpOnExit =
@@ -71,7 +109,7 @@ void SendOp::handle(PubackMsg& msg)
                 completeWithCb(status, responsePtr);
             });
 
-    if (m_pubMsg.transportField_flags().field_qos().value() != Qos::AtLeastOnceDelivery) {
+    if (m_qos != Qos::AtLeastOnceDelivery) {
         errorLog("Unexpected PUBACK for Qos2 message");
         return;
     }
@@ -84,8 +122,9 @@ void SendOp::handle(PubackMsg& msg)
         confirmRegisteredAlias();
     }
 
-    if (msg.field_properties().doesExist()) {
+    if (msg.field_properties().doesExist() && needsResponseProps(true)) {
         PropsHandler propsHandler;
+        propsHandler.m_lazyUserProps = isLazyProps();
         for (auto& p : msg.field_properties().field().value()) {
             p.currentFieldExec(propsHandler);
         }
@@ -105,15 +144,21 @@ void SendOp::handle(PubackMsg& msg)
         }
 
         if constexpr (Config::HasUserProps) {
-            if (!propsHandler.m_userProps.empty()) {
+            if (propsHandler.hasUserProps()) {
                 if (!client().sessionState().m_problemInfoAllowed) {
                     errorLog("Received user properties in PUBACK when \"problem information\" was disabled in CONNECT.");
                     return;
                 }
 
-                fillUserProps(propsHandler, userProps);
-                response.m_userProps = &userProps[0];
-                comms::cast_assign(response.m_userPropsCount) = userProps.size();
+                if (propsHandler.m_hasLazyUserProps) {
+                    setLazyUserProps<PropsHandler>(msg.field_properties().field().value(), userProps, lazyUserProps);
+                    response.m_lazyUserProps = lazyUserProps.toHandle();
+                }
+                else {
+                    fillUserProps(propsHandler, userProps);
+                    response.m_userProps = &userProps[0];
+                    comms::cast_assign(response.m_userPropsCount) = userProps.size();
+                }
             }
         }
     }
@@ -127,7 +172,7 @@ void SendOp::handle(PubackMsg& msg)
 void SendOp::handle(PubrecMsg& msg)
 {
     static_assert(Config::MaxQos >= 2);
-    if (m_pubMsg.field_packetId().field().value() != msg.field_packetId().value()) {
+    if (m_packetId != msg.field_packetId().value()) {
         return;
     }
 
@@ -146,6 +191,7 @@ void SendOp::handle(PubrecMsg& msg)
 
     auto status = CC_Mqtt5AsyncOpStatus_ProtocolError;
     UserPropsList userProps; // Will be referenced in response
+    LazyUserProps lazyUserProps; // Will be referenced in response
     auto response = CC_Mqtt5PublishResponse();
 
     auto completeOpOnExit =
@@ -160,7 +206,7 @@ void SendOp::handle(PubrecMsg& msg)
                 completeWithCb(status, responsePtr);
             });
 
-    if (m_pubMsg.transportField_flags().field_qos().value() != Qos::ExactlyOnceDelivery) {
+    if (m_qos != Qos::ExactlyOnceDelivery) {
         errorLog("Unexpected PUBREC for Qos1 message");
         return;
     }
@@ -170,8 +216,13 @@ void SendOp::handle(PubrecMsg& msg)
         return;
     }
 
-    if (msg.field_properties().doesExist()) {
+    bool failureReported =
+        (msg.field_reasonCode().doesExist()) &&
+        (msg.field_reasonCode().field().value() >= PubrecMsg::Field_reasonCode::Field::ValueType::UnspecifiedError);
+
+    if (msg.field_properties().doesExist() && needsResponseProps(failureReported)) {
         PropsHandler propsHandler;
+        propsHandler.m_lazyUserProps = isLazyProps();
         for (auto& p : msg.field_properties().field().value()) {
             p.currentFieldExec(propsHandler);
         }
@@ -191,15 +242,21 @@ void SendOp::handle(PubrecMsg& msg)
         }
 
         if constexpr (Config::HasUserProps) {
-            if (!propsHandler.m_userProps.empty()) {
+            if (propsHandler.hasUserProps()) {
                 if (!client().sessionState().m_problemInfoAllowed) {
                     errorLog("Received user properties in PUBREC when \"problem information\" was disabled in CONNECT.");
                     return;
                 }
 
-                fillUserProps(propsHandler, userProps);
-                response.m_userProps = &userProps[0];
-                comms::cast_assign(response.m_userPropsCount) = userProps.size();
+                if (propsHandler.m_hasLazyUserProps) {
+                    setLazyUserProps<PropsHandler>(msg.field_properties().field().value(), userProps, lazyUserProps);
+                    response.m_lazyUserProps = lazyUserProps.toHandle();
+                }
+                else {
+                    fillUserProps(propsHandler, userProps);
+                    response.m_userProps = &userProps[0];
+                    comms::cast_assign(response.m_userPropsCount) = userProps.size();
+                }
             }
         }
     }
@@ -207,8 +264,7 @@ void SendOp::handle(PubrecMsg& msg)
     // Protocol wise it's all correct, no need to terminate any more
     terminateOnExit.release();
 
-    if ((msg.field_reasonCode().doesExist()) &&
-        (msg.field_reasonCode().field().value() >= PubrecMsg::Field_reasonCode::Field::ValueType::UnspecifiedError)) {
+    if (failureReported) {
         comms::cast_assign(response.m_reasonCode) = msg.field_reasonCode().field().value();
         status = CC_Mqtt5AsyncOpStatus_Complete;
         return;
@@ -220,8 +276,9 @@ void SendOp::handle(PubrecMsg& msg)
 
     m_acked = true;
     m_sendAttempts = 0U;
+    releaseEncodedMsg(); // PUBLISH is not going to be re-sent any more
     PubrelMsg pubrelMsg;
-    pubrelMsg.field_packetId().setValue(m_pubMsg.field_packetId().field().value());
+    pubrelMsg.field_packetId().setValue(m_packetId);
     auto result = client().sendMessage(pubrelMsg);
     if (result != CC_Mqtt5ErrorCode_Success) {
         errorLog("Failed to resend PUBREL message.");
@@ -238,7 +295,7 @@ void SendOp::handle(PubrecMsg& msg)
 void SendOp::handle(PubcompMsg& msg)
 {
     static_assert(Config::MaxQos >= 2);
-    if (m_pubMsg.field_packetId().field().value() != msg.field_packetId().value()) {
+    if (m_packetId != msg.field_packetId().value()) {
         return;
     }
 
@@ -254,6 +311,7 @@ void SendOp::handle(PubcompMsg& msg)
 
     auto status = CC_Mqtt5AsyncOpStatus_ProtocolError;
     UserPropsList userProps; // Will be referenced in response
+    LazyUserProps lazyUserProps; // Will be referenced in response
     auto response = CC_Mqtt5PublishResponse();
 
     auto completeOpOnExit =
@@ -268,7 +326,7 @@ void SendOp::handle(PubcompMsg& msg)
                 completeWithCb(status, responsePtr);
             });
 
-    if (m_pubMsg.transportField_flags().field_qos().value() != Qos::ExactlyOnceDelivery) {
+    if (m_qos != Qos::ExactlyOnceDelivery) {
         errorLog("Unexpected PUBCOMP for Qos1 message");
         return;
     }
@@ -284,8 +342,9 @@ void SendOp::handle(PubcompMsg& msg)
         comms::cast_assign(response.m_reasonCode) = msg.field_reasonCode().field().value();
     }
 
-    if (msg.field_properties().doesExist()) {
+    if (msg.field_properties().doesExist() && needsResponseProps(true)) {
         PropsHandler propsHandler;
+        propsHandler.m_lazyUserProps = isLazyProps();
         for (auto& p : msg.field_properties().field().value()) {
             p.currentFieldExec(propsHandler);
         }
@@ -304,15 +363,21 @@ void SendOp::handle(PubcompMsg& msg)
             response.m_reasonStr = propsHandler.m_reasonStr->field_value().value().c_str();
         }
 
-        if (!propsHandler.m_userProps.empty()) {
+        if (propsHandler.hasUserProps()) {
             if (!client().sessionState().m_problemInfoAllowed) {
                 errorLog("Received user properties in PUBCOMP when \"problem information\" was disabled in CONNECT.");
                 return;
             }
 
-            fillUserProps(propsHandler, userProps);
-            response.m_userProps = &userProps[0];
-            comms::cast_assign(response.m_userPropsCount) = userProps.size();
+            if (propsHandler.m_hasLazyUserProps) {
+                setLazyUserProps<PropsHandler>(msg.field_properties().field().value(), userProps, lazyUserProps);
+                response.m_lazyUserProps = lazyUserProps.toHandle();
+            }
+            else {
+                fillUserProps(propsHandler, userProps);
+                response.m_userProps = &userProps[0];
+                comms::cast_assign(response.m_userPropsCount) = userProps.size();
+            }
         }
     }
 
@@ -346,112 +411,21 @@ CC_Mqtt5ErrorCode SendOp::configBasic(const CC_Mqtt5PublishBasicConfig& config)
         return CC_Mqtt5ErrorCode_BadParam;
     }
 
-    unsigned alias = 0U;
-    bool mustAssignTopic = true;
-    do {
-        if constexpr (Config::HasTopicAliases) {
-            if (config.m_topicAliasPref == CC_Mqtt5TopicAliasPreference_ForceTopicOnly) {
-                break;
-            }
-
-            auto& clientState = client().clientState();
-            auto iter =
-                std::lower_bound(
-                    clientState.m_sendTopicAliases.begin(), clientState.m_sendTopicAliases.end(), config.m_topic,
-                    [](auto& info, const char* topicParam)
-                    {
-                        return info.m_topic < topicParam;
-                    });
-
-            bool found = ((iter != clientState.m_sendTopicAliases.end()) && (iter->m_topic == config.m_topic));
-            if (!found) {
-                if ((config.m_topicAliasPref == CC_Mqtt5TopicAliasPreference_ForceTopicWithAlias) ||
-                    (config.m_topicAliasPref == CC_Mqtt5TopicAliasPreference_ForceAliasOnly)) {
-                    errorLog("The topic alias for the publish hasn't been allocated");
-                    return CC_Mqtt5ErrorCode_BadParam;
-                }
-
-                COMMS_ASSERT(config.m_topicAliasPref == CC_Mqtt5TopicAliasPreference_UseAliasIfAvailable);
-                break;
-            }
-
-            alias = iter->m_alias;
-
-            if (config.m_topicAliasPref == CC_Mqtt5TopicAliasPreference_ForceTopicWithAlias) {
-                break;
-            }
-
-            if (config.m_topicAliasPref == CC_Mqtt5TopicAliasPreference_ForceAliasOnly) {
-                mustAssignTopic = false;
-                break;
-            }
-
-            if (iter->m_lowQosRegRemCount == 0U) {
-                mustAssignTopic = false;
-                break;
-            }
-
-            // if (config.m_qos > CC_Mqtt5QoS_AtMostOnceDelivery) {
-            //     break;
-            // }
-
-            --iter->m_lowQosRegRemCount;
-        }
-        else {
-            if ((config.m_topicAliasPref != CC_Mqtt5TopicAliasPreference_UseAliasIfAvailable) &&
-                (config.m_topicAliasPref != CC_Mqtt5TopicAliasPreference_ForceTopicOnly)) {
-                errorLog("Topic aliases are not supported");
-                return CC_Mqtt5ErrorCode_NotSupported;
-            }
-        }
-    } while (false);
-
-    m_pubMsg.transportField_flags().field_retain().setBitValue_bit(config.m_retain);
-    m_pubMsg.transportField_flags().field_qos().setValue(config.m_qos);
-
-    if (mustAssignTopic) {
-        auto& topicStr = m_pubMsg.field_topic().value();
-        topicStr = config.m_topic;
-        m_topicConfigured = true;
-
-        if (maxStringLen() < topicStr.size()) {
-            errorLog("Publish topic value is too long");
-            return CC_Mqtt5ErrorCode_BadParam;
-        }
-    }
-
-    auto& propsField = m_pubMsg.field_properties();
-    if (alias > 0U) {
-        if (!canAddProp(propsField)) {
-            errorLog("Cannot add topic alias property, reached available limit.");
-            return CC_Mqtt5ErrorCode_OutOfMemory;
-        }
-
-        auto& propVar = addProp(propsField);
-        auto& propBundle = propVar.initField_topicAlias();
-        auto& valueField = propBundle.field_value();
-        valueField.setValue(alias);
-        m_topicConfigured = true;
-    }
-
-    auto& dataVec = m_pubMsg.field_payload().value();
-    if (config.m_dataLen > 0U) {
-        COMMS_ASSERT(config.m_data != nullptr);
-        comms::util::assign(dataVec, config.m_data, config.m_data + config.m_dataLen);
-    }
+    m_msg->transportField_flags().field_retain().setBitValue_bit(config.m_retain);
+    m_msg->transportField_flags().field_qos().setValue(config.m_qos);
+    m_qos = m_msg->transportField_flags().field_qos().value();
 
-    if (maxStringLen() < dataVec.size()) {
-        errorLog("Publish data value is too long");
-        return CC_Mqtt5ErrorCode_BadParam;
+    auto ec = configTopic(config.m_topic, config.m_topicAliasPref);
+    if (ec != CC_Mqtt5ErrorCode_Success) {
+        return ec;
     }
 
-    m_registeredAlias = (alias > 0) && mustAssignTopic;
-    return CC_Mqtt5ErrorCode_Success;
+    return configPayload(config.m_data, config.m_dataLen, config.m_borrowData);
 }
 
 CC_Mqtt5ErrorCode SendOp::configExtra(const CC_Mqtt5PublishExtraConfig& config)
 {
-    auto& propsField = m_pubMsg.field_properties();
+    auto& propsField = m_msg->field_properties();
 
     if (config.m_contentType != nullptr) {
         if (!canAddProp(propsField)) {
@@ -554,10 +528,82 @@ CC_Mqtt5ErrorCode SendOp::configExtra(const CC_Mqtt5PublishExtraConfig& config)
 
 CC_Mqtt5ErrorCode SendOp::addUserProp(const CC_Mqtt5UserProp& prop)
 {
-    auto& propsField = m_pubMsg.field_properties();
+    auto& propsField = m_msg->field_properties();
     return addUserPropToList(propsField, prop);
 }
 
+CC_Mqtt5ErrorCode SendOp::configTemplate(
+    PublishTemplate& tmpl,
+    const unsigned char* data,
+    unsigned dataLen,
+    const unsigned char* correlationData,
+    unsigned correlationDataLen)
+{
+    auto& state = client().sessionState();
+    auto& tmplFlags = tmpl.m_pubMsg.transportField_flags();
+    auto qos = static_cast<CC_Mqtt5QoS>(tmplFlags.field_qos().value());
+    if (qos > state.m_pubMaxQos) {
+        errorLog("QoS value of the publish template is too high for the current session.");
+        return CC_Mqtt5ErrorCode_BadParam;
+    }
+
+    if (tmplFlags.field_retain().getBitValue_bit() && (!state.m_retainAvailable)) {
+        errorLog("Retain is not supported by the broker");
+        return CC_Mqtt5ErrorCode_BadParam;
+    }
+
+    if ((correlationDataLen > 0U) && (correlationData == nullptr)) {
+        errorLog("Bad correlation data parameter in publish template send.");
+        return CC_Mqtt5ErrorCode_BadParam;
+    }
+
+    // The template message is sent as is, the changes are reverted in releaseTemplate()
+    COMMS_ASSERT(m_msg == &tmpl.m_pubMsg);
+    COMMS_ASSERT(!tmpl.m_correlationDataReplaced);
+    m_tmpl = &tmpl;
+    m_qos = m_msg->transportField_flags().field_qos().value();
+
+    if (correlationData != nullptr) {
+        auto& propsField = m_msg->field_properties();
+        auto& propsVec = propsField.value();
+        if (tmpl.m_correlationDataIdx >= propsVec.size()) {
+            if (!canAddProp(propsField)) {
+                errorLog("Cannot add publish property, reached available limit.");
+                return CC_Mqtt5ErrorCode_OutOfMemory;
+            }
+
+            addProp(propsField).initField_correlationData();
+        }
+        else {
+            propsVec[tmpl.m_correlationDataIdx].accessField_correlationData().field_value().value().swap(tmpl.m_savedCorrelationData);
+            tmpl.m_correlationDataReplaced = true;
+        }
+
+        auto& propVar = (tmpl.m_correlationDataIdx < propsVec.size()) ? propsVec[tmpl.m_correlationDataIdx] : propsVec.back();
+        auto& valueField = propVar.accessField_correlationData().field_value();
+        comms::util::assign(valueField.value(), correlationData, correlationData + correlationDataLen);
+
+        if (maxStringLen() < valueField.value().size()) {
+            errorLog("Publish correlation data value is too long");
+            return CC_Mqtt5ErrorCode_BadParam;
+        }
+    }
+
+    auto ec = configTopic(tmpl.m_pubMsg.field_topic().value().c_str(), tmpl.m_topicAliasPref);
+    if (ec != CC_Mqtt5ErrorCode_Success) {
+        return ec;
+    }
+
+    // The data is valid till the end of the send call, copied by releaseTemplate() if needed afterwards
+    return configPayload(data, dataLen, true);
+}
+
+const PublishMsg& SendOp::pubMsg() const
+{
+    COMMS_ASSERT(m_msg != nullptr);
+    return *m_msg;
+}
+
 CC_Mqtt5ErrorCode SendOp::setResendAttempts(unsigned attempts)
 {
     if (attempts == 0U) {
@@ -585,11 +631,6 @@ CC_Mqtt5ErrorCode SendOp::send(CC_Mqtt5PublishCompleteCb cb, void* cbData)
                 opCompleteInternal();
             });
 
-    if (!m_responseTimer.isValid()) {
-        errorLog("The library cannot allocate required number of timers.");
-        return CC_Mqtt5ErrorCode_InternalError;
-    }
-
     if (!m_topicConfigured) {
         errorLog("Topic hasn't been properly configured, cannot publish");
         return CC_Mqtt5ErrorCode_InsufficientConfig;
@@ -598,30 +639,65 @@ CC_Mqtt5ErrorCode SendOp::send(CC_Mqtt5PublishCompleteCb cb, void* cbData)
     m_cb = cb;
     m_cbData = cbData;
 
-    if (m_pubMsg.transportField_flags().field_qos().value() > Qos::AtMostOnceDelivery) {
-        m_pubMsg.field_packetId().field().setValue(allocPacketId());
+    if (m_qos > Qos::AtMostOnceDelivery) {
+        m_packetId = allocPacketId();
+        m_msg->field_packetId().field().setValue(m_packetId);
+        client().registerSendOpPacketId(*this);
     }
 
-    m_pubMsg.doRefresh(); // Update packetId presence
+    m_msg->doRefresh(); // Update packetId presence
 
     if (!canSend()) {
         COMMS_ASSERT(!m_paused);
         m_paused = true;
 
+        releaseTemplate(true);
         completeOnExit.release(); // don't complete op yet
         return CC_Mqtt5ErrorCode_Success;
     }
 
     auto guard = client().apiEnter();
+    bool completesOnSend = (m_qos == Qos::AtMostOnceDelivery);
     auto sendResult = doSendInternal();
     if (sendResult != CC_Mqtt5ErrorCode_Success) {
         return sendResult;
     }
 
+    if (!completesOnSend) {
+        releaseTemplate(true);
+    }
+
     completeOnExit.release(); // don't complete op in this context
     return sendResult;
 }
 
+CC_Mqtt5ErrorCode SendOp::sendTransient(CC_Mqtt5PublishCompleteCb cb, void* cbData)
+{
+    // The QoS0 message is sent right away without registration in the client
+    COMMS_ASSERT(isTransient());
+    COMMS_ASSERT(qos() == Qos::AtMostOnceDelivery);
+
+    if (!m_topicConfigured) {
+        errorLog("Topic hasn't been properly configured, cannot publish");
+        return CC_Mqtt5ErrorCode_InsufficientConfig;
+    }
+
+    m_msg->doRefresh(); // Update packetId presence
+
+    auto guard = client().apiEnter();
+    auto sendResult = sendPublishMsg();
+    if (sendResult != CC_Mqtt5ErrorCode_Success) {
+        return sendResult;
+    }
+
+    releaseTemplate(false); // The callback may use the template again
+    if (cb != nullptr) {
+        cb(cbData, toHandle(), CC_Mqtt5AsyncOpStatus_Complete, nullptr);
+    }
+
+    return CC_Mqtt5ErrorCode_Success;
+}
+
 CC_Mqtt5ErrorCode SendOp::cancel()
 {
     if (m_cb == nullptr) {
@@ -641,7 +717,13 @@ void SendOp::postReconnectionResend()
 
     if constexpr (Config::HasTopicAliases) {
         do {
-            auto& propsVec = m_pubMsg.field_properties().value();
+            if (m_msg == nullptr) {
+                // Released after serialization, the topic alias is not used
+                COMMS_ASSERT(!m_hasTopicAlias);
+                break;
+            }
+
+            auto& propsVec = m_msg->field_properties().value();
             auto iter =
                 std::find_if(
                     propsVec.begin(), propsVec.end(),
@@ -650,7 +732,7 @@ void SendOp::postReconnectionResend()
                     });
 
             if (iter == propsVec.end()) {
-                COMMS_ASSERT(!m_pubMsg.field_topic().value().empty());
+                COMMS_ASSERT(!m_msg->field_topic().value().empty());
                 break;
             }
 
@@ -660,7 +742,7 @@ void SendOp::postReconnectionResend()
                 break;
             }
 
-            if (m_pubMsg.field_topic().value().empty()) {
+            if (m_msg->field_topic().value().empty()) {
                 auto& topicAliasField = iter->accessField_topicAlias();
                 auto topicAliasValue = topicAliasField.field_value().value();
 
@@ -680,10 +762,13 @@ void SendOp::postReconnectionResend()
                     return;
                 }
 
-                m_pubMsg.field_topic().value() = infoIter->m_topic.c_str();
+                m_msg->field_topic().value() = infoIter->m_topic.c_str();
             }
 
             propsVec.erase(iter);
+            m_hasTopicAlias = false;
+            m_registeredAlias = false; // The registration is not resent, nothing to confirm
+            m_encodedMsg.clear(); // Needs to be re-serialized without the alias
         } while (false);
     }
 
@@ -693,6 +778,39 @@ void SendOp::postReconnectionResend()
     resendDupMsg();
 }
 
+void SendOp::acquireBufs(RecycledBufsList& bufs)
+{
+    if constexpr (ExtConfig::HasObjRecycling) {
+        acquireRecycledBuf(m_encodedMsg, bufs);
+
+        if constexpr (IsPayloadRecyclable) {
+            if (m_pubMsg) {
+                acquireRecycledBuf(m_pubMsg->field_payload().value(), bufs);
+            }
+        }
+    }
+    else {
+        static_cast<void>(bufs);
+    }
+}
+
+void SendOp::releaseBufs(RecycledBufsList& bufs)
+{
+    if constexpr (ExtConfig::HasObjRecycling) {
+        releaseRecycledBuf(m_encodedMsg, bufs);
+        releaseRecycledBuf(m_payload, bufs);
+
+        if constexpr (IsPayloadRecyclable) {
+            if (m_pubMsg) {
+                releaseRecycledBuf(m_pubMsg->field_payload().value(), bufs);
+            }
+        }
+    }
+    else {
+        static_cast<void>(bufs);
+    }
+}
+
 void SendOp::forceDupResend()
 {
     if (m_paused) {
@@ -740,16 +858,9 @@ void SendOp::terminateOpImpl(CC_Mqtt5AsyncOpStatus status)
     completeWithCb(status);
 }
 
-void SendOp::connectivityChangedImpl()
-{
-    m_responseTimer.setSuspended(
-        (!client().sessionState().m_connected) || client().clientState().m_networkDisconnected);
-}
-
 void SendOp::restartResponseTimer()
 {
-    auto& state = client().configState();
-    m_responseTimer.wait(state.m_responseTimeoutMs, &SendOp::recvTimeoutCb, this);
+    m_responseTimer.wait(getResponseTimeout(), &SendOp::recvTimeoutCb, this);
 }
 
 void SendOp::responseTimeoutInternal()
@@ -769,8 +880,17 @@ void SendOp::resendDupMsg()
 
     COMMS_ASSERT(m_published);
     if (!m_acked) {
-        m_pubMsg.transportField_flags().field_dup().setBitValue_bit(true);
-        auto result = client().sendMessage(m_pubMsg);
+        if (m_msg != nullptr) {
+            m_msg->transportField_flags().field_dup().setBitValue_bit(true);
+        }
+
+        if (!m_encodedMsg.empty()) {
+            // The DUP flag is the bit 3 of the fixed header
+            static constexpr std::uint8_t DupFlagMask = 0x8;
+            m_encodedMsg[0] |= DupFlagMask;
+        }
+
+        auto result = sendPublishMsg();
         if (result != CC_Mqtt5ErrorCode_Success) {
             errorLog("Failed to resend PUBLISH message.");
             completeWithCb(CC_Mqtt5AsyncOpStatus_InternalError);
@@ -782,9 +902,9 @@ void SendOp::resendDupMsg()
         return;
     }
 
-    COMMS_ASSERT(m_pubMsg.transportField_flags().field_qos().value() == Qos::ExactlyOnceDelivery);
+    COMMS_ASSERT(m_qos == Qos::ExactlyOnceDelivery);
     PubrelMsg pubrelMsg;
-    pubrelMsg.field_packetId().setValue(m_pubMsg.field_packetId().field().value());
+    pubrelMsg.field_packetId().setValue(m_packetId);
     auto result = client().sendMessage(pubrelMsg);
     if (result != CC_Mqtt5ErrorCode_Success) {
         errorLog("Failed to resend PUBREL message.");
@@ -813,10 +933,11 @@ void SendOp::completeWithCb(CC_Mqtt5AsyncOpStatus status, const CC_Mqtt5PublishR
 
 void SendOp::confirmRegisteredAlias()
 {
-    COMMS_ASSERT(!m_pubMsg.field_topic().value().empty());
+    COMMS_ASSERT(m_msg != nullptr);
+    COMMS_ASSERT(!m_msg->field_topic().value().empty());
     COMMS_ASSERT(m_registeredAlias);
     auto& clientState = client().clientState();
-    auto& topic = m_pubMsg.field_topic().value();
+    auto& topic = m_msg->field_topic().value();
     auto iter =
         std::lower_bound(
             clientState.m_sendTopicAliases.begin(), clientState.m_sendTopicAliases.end(), topic,
@@ -836,7 +957,7 @@ void SendOp::confirmRegisteredAlias()
 CC_Mqtt5ErrorCode SendOp::doSendInternal()
 {
     m_sendAttempts = 0U;
-    auto result = client().sendMessage(m_pubMsg);
+    auto result = sendPublishMsg();
     if (result != CC_Mqtt5ErrorCode_Success) {
         return result;
     }
@@ -849,7 +970,7 @@ CC_Mqtt5ErrorCode SendOp::doSendInternal()
     COMMS_ASSERT(0U < client().clientState().m_inFlightSends);
     ++m_sendAttempts;
 
-    if (m_pubMsg.transportField_flags().field_qos().value() == Qos::AtMostOnceDelivery) {
+    if (m_qos == Qos::AtMostOnceDelivery) {
         completeWithCb(CC_Mqtt5AsyncOpStatus_Complete);
         return CC_Mqtt5ErrorCode_Success;
     }
@@ -858,10 +979,49 @@ CC_Mqtt5ErrorCode SendOp::doSendInternal()
     return CC_Mqtt5ErrorCode_Success;
 }
 
+CC_Mqtt5ErrorCode SendOp::sendPublishMsg()
+{
+    if constexpr (ExtConfig::HasPublishCache) {
+        // Only QoS1 and QoS2 messages can be re-sent
+        if (m_qos > Qos::AtMostOnceDelivery) {
+            if (m_encodedMsg.empty()) {
+                COMMS_ASSERT(m_msg != nullptr);
+                if constexpr (IsPayloadRecyclable) {
+                    auto& payload = m_msg->field_payload().value();
+                    if ((m_borrowedData == nullptr) && (!payload.empty())) {
+                        // Reported as a separate segment, no need to copy it into the encoded message
+                        m_payload.swap(payload);
+                        m_borrowedData = &m_payload[0];
+                        m_borrowedDataLen = static_cast<unsigned>(m_payload.size());
+                    }
+                }
+
+                auto ec = client().serializeMessage(*m_msg, m_encodedMsg, m_borrowedDataLen);
+                if (ec != CC_Mqtt5ErrorCode_Success) {
+                    return ec;
+                }
+
+                releasePubMsg();
+            }
+
+            return client().sendSerialized(&m_encodedMsg[0], m_encodedMsg.size(), m_borrowedData, m_borrowedDataLen);
+        }
+    }
+
+    COMMS_ASSERT(m_msg != nullptr);
+    return client().sendMessage(*m_msg, m_borrowedData, m_borrowedDataLen);
+}
+
+bool SendOp::needsResponseProps(bool reported) const
+{
+    // In the lazy mode the properties are not even walked when there is nobody to see them
+    return (!isLazyProps()) || (reported && (m_cb != nullptr));
+}
+
 bool SendOp::canSend() const
 {
     bool reachedLimit = (client().sessionState().m_highQosSendLimit <= client().clientState().m_inFlightSends);
-    auto qos = m_pubMsg.transportField_flags().field_qos().value();
+    auto qos = m_qos;
 
     if (reachedLimit) {
         return
@@ -883,8 +1043,107 @@ bool SendOp::canSend() const
     return true;
 }
 
+void SendOp::releasePubMsg()
+{
+    // The serialized message is all that is needed for the re-sends unless
+    // the topic alias needs to be replaced with the topic on reconnection.
+    if (m_hasTopicAlias) {
+        return;
+    }
+
+    if constexpr (ExtConfig::HasObjRecycling && IsPayloadRecyclable) {
+        if (m_pubMsg) {
+            releaseRecycledBuf(m_pubMsg->field_payload().value(), client().recycledSendBufs());
+        }
+    }
+
+    m_pubMsg.reset();
+    m_msg = nullptr;
+}
+
+void SendOp::releaseTemplate(bool keepMsg)
+{
+    if (m_tmpl == nullptr) {
+        return;
+    }
+
+    auto& tmpl = *m_tmpl;
+    m_tmpl = nullptr;
+
+    if (m_msg == &tmpl.m_pubMsg) {
+        m_msg = nullptr;
+        if (keepMsg) {
+            // Still needed for the future (re)sends
+            m_pubMsg = client().allocPubMsg();
+            COMMS_ASSERT(m_pubMsg);
+            *m_pubMsg = tmpl.m_pubMsg;
+            m_msg = m_pubMsg.get();
+        }
+    }
+
+    do {
+        if ((!keepMsg) || tmpl.m_borrowData || (m_borrowedDataLen == 0U)) {
+            break;
+        }
+
+        // The application's data is not guaranteed to be valid after the send call
+        if constexpr (ExtConfig::HasPublishCache) {
+            if (!m_encodedMsg.empty()) {
+                // Serialized without the payload
+                comms::util::assign(m_payload, m_borrowedData, m_borrowedData + m_borrowedDataLen);
+                m_borrowedData = &m_payload[0];
+                break;
+            }
+        }
+
+        COMMS_ASSERT(m_msg != nullptr);
+        comms::util::assign(m_msg->field_payload().value(), m_borrowedData, m_borrowedData + m_borrowedDataLen);
+        m_borrowedData = nullptr;
+        m_borrowedDataLen = 0U;
+    } while (false);
+
+    // Revert the template to its original state
+    auto& topic = tmpl.m_pubMsg.field_topic().value();
+    if (topic.empty()) {
+        topic.swap(tmpl.m_savedTopic);
+    }
+
+    auto& propsVec = tmpl.m_pubMsg.field_properties().value();
+    while (tmpl.m_propsCount < propsVec.size()) {
+        propsVec.pop_back();
+    }
+
+    if (tmpl.m_correlationDataReplaced) {
+        COMMS_ASSERT(tmpl.m_correlationDataIdx < propsVec.size());
+        propsVec[tmpl.m_correlationDataIdx].accessField_correlationData().field_value().value().swap(tmpl.m_savedCorrelationData);
+        tmpl.m_correlationDataReplaced = false;
+    }
+}
+
+void SendOp::releaseEncodedMsg()
+{
+    if constexpr (ExtConfig::HasPublishCache) {
+        if ((!m_payload.empty()) && (m_borrowedData == &m_payload[0])) {
+            m_borrowedData = nullptr;
+            m_borrowedDataLen = 0U;
+        }
+
+        if constexpr (ExtConfig::HasObjRecycling) {
+            auto& bufs = client().recycledSendBufs();
+            releaseRecycledBuf(m_encodedMsg, bufs);
+            releaseRecycledBuf(m_payload, bufs);
+        }
+
+        // Release the capacity if not recycled
+        EncodedMsgBuf().swap(m_encodedMsg);
+        EncodedMsgBuf().swap(m_payload);
+    }
+}
+
 void SendOp::opCompleteInternal()
 {
+    releaseTemplate(false); // Before the callback which may use the template again
+
     if (m_published) {
         COMMS_ASSERT(0U < client().clientState().m_inFlightSends);
         --client().clientState().m_inFlightSends;
@@ -893,6 +1152,130 @@ void SendOp::opCompleteInternal()
     opComplete();
 }
 
+CC_Mqtt5ErrorCode SendOp::configTopic(const char* topic, CC_Mqtt5TopicAliasPreference topicAliasPref)
+{
+    unsigned alias = 0U;
+    bool mustAssignTopic = true;
+    do {
+        if constexpr (Config::HasTopicAliases) {
+            if (topicAliasPref == CC_Mqtt5TopicAliasPreference_ForceTopicOnly) {
+                break;
+            }
+
+            auto& clientState = client().clientState();
+            auto iter =
+                std::lower_bound(
+                    clientState.m_sendTopicAliases.begin(), clientState.m_sendTopicAliases.end(), topic,
+                    [](auto& info, const char* topicParam)
+                    {
+                        return info.m_topic < topicParam;
+                    });
+
+            bool found = ((iter != clientState.m_sendTopicAliases.end()) && (iter->m_topic == topic));
+            if (!found) {
+                if ((topicAliasPref == CC_Mqtt5TopicAliasPreference_ForceTopicWithAlias) ||
+                    (topicAliasPref == CC_Mqtt5TopicAliasPreference_ForceAliasOnly)) {
+                    errorLog("The topic alias for the publish hasn't been allocated");
+                    return CC_Mqtt5ErrorCode_BadParam;
+                }
+
+                COMMS_ASSERT(topicAliasPref == CC_Mqtt5TopicAliasPreference_UseAliasIfAvailable);
+                break;
+            }
+
+            alias = iter->m_alias;
+
+            if (topicAliasPref == CC_Mqtt5TopicAliasPreference_ForceTopicWithAlias) {
+                break;
+            }
+
+            if (topicAliasPref == CC_Mqtt5TopicAliasPreference_ForceAliasOnly) {
+                mustAssignTopic = false;
+                break;
+            }
+
+            if (iter->m_lowQosRegRemCount == 0U) {
+                mustAssignTopic = false;
+                break;
+            }
+
+            --iter->m_lowQosRegRemCount;
+        }
+        else {
+            if ((topicAliasPref != CC_Mqtt5TopicAliasPreference_UseAliasIfAvailable) &&
+                (topicAliasPref != CC_Mqtt5TopicAliasPreference_ForceTopicOnly)) {
+                errorLog("Topic aliases are not supported");
+                return CC_Mqtt5ErrorCode_NotSupported;
+            }
+        }
+    } while (false);
+
+    auto& topicStr = m_msg->field_topic().value();
+    if (mustAssignTopic) {
+        if (topicStr.c_str() != topic) {
+            // Unless the template's topic is already in place
+            topicStr = topic;
+        }
+
+        m_topicConfigured = true;
+
+        if (maxStringLen() < topicStr.size()) {
+            errorLog("Publish topic value is too long");
+            return CC_Mqtt5ErrorCode_BadParam;
+        }
+    }
+    else if (m_tmpl != nullptr) {
+        COMMS_ASSERT(m_tmpl->m_savedTopic.empty());
+        topicStr.swap(m_tmpl->m_savedTopic);
+    }
+    else {
+        topicStr.clear();
+    }
+
+    auto& propsField = m_msg->field_properties();
+    if (alias > 0U) {
+        if (!canAddProp(propsField)) {
+            errorLog("Cannot add topic alias property, reached available limit.");
+            return CC_Mqtt5ErrorCode_OutOfMemory;
+        }
+
+        auto& propVar = addProp(propsField);
+        auto& propBundle = propVar.initField_topicAlias();
+        auto& valueField = propBundle.field_value();
+        valueField.setValue(alias);
+        m_topicConfigured = true;
+    }
+
+    m_hasTopicAlias = (alias > 0U);
+    m_registeredAlias = m_hasTopicAlias && mustAssignTopic;
+    return CC_Mqtt5ErrorCode_Success;
+}
+
+CC_Mqtt5ErrorCode SendOp::configPayload(const unsigned char* data, unsigned dataLen, bool borrowData)
+{
+    auto& dataVec = m_msg->field_payload().value();
+    m_borrowedData = nullptr;
+    m_borrowedDataLen = 0U;
+    if (dataLen > 0U) {
+        COMMS_ASSERT(data != nullptr);
+        if (borrowData) {
+            dataVec.clear();
+            m_borrowedData = data;
+            m_borrowedDataLen = dataLen;
+        }
+        else {
+            comms::util::assign(dataVec, data, data + dataLen);
+        }
+    }
+
+    if (maxStringLen() < (dataVec.size() + m_borrowedDataLen)) {
+        errorLog("Publish data value is too long");
+        return CC_Mqtt5ErrorCode_BadParam;
+    }
+
+    return CC_Mqtt5ErrorCode_Success;
+}
+
 void SendOp::recvTimeoutCb(void* data)
 {
     asSendOp(data)->responseTimeoutInternal();
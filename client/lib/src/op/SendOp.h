@@ -9,11 +9,12 @@
 
 #include "op/Op.h"
 #include "ExtConfig.h"
+#include "ObjAllocator.h"
 #include "ProtocolDefs.h"
+#include "PublishTemplate.h"
+#include "ResponseTimeoutQueue.h"
 #include "TopicAliasDefs.h"
 
-#include "TimerMgr.h"
-
 namespace cc_mqtt5_client
 {
 
@@ -24,10 +25,13 @@ class SendOp final : public Op
 {
     using Base = Op;
 public:
-    explicit SendOp(ClientImpl& client);
+    explicit SendOp(ClientImpl& client, PublishMsg* msg = nullptr);
     ~SendOp();
 
     using Base::handle;
+    using EncodedMsgBuf = ObjListType<std::uint8_t, 0U, ExtConfig::HasPublishCache>;
+    using RecycledBufsList = ObjListType<EncodedMsgBuf, 0U, ExtConfig::HasObjRecycling>;
+    using PubMsgAlloc = ObjAllocator<PublishMsg, ExtConfig::PubMsgsLimit>;
 
 #if CC_MQTT5_CLIENT_MAX_QOS >= 1
     virtual void handle(PubackMsg& msg) override;
@@ -55,22 +59,32 @@ public:
 
     unsigned packetId() const
     {
-        return m_pubMsg.field_packetId().field().value();
+        return m_packetId;
     }
 
     Qos qos() const
     {
-        return m_pubMsg.transportField_flags().field_qos().value();
+        return m_qos;
     }
 
     CC_Mqtt5ErrorCode configBasic(const CC_Mqtt5PublishBasicConfig& config);
     CC_Mqtt5ErrorCode configExtra(const CC_Mqtt5PublishExtraConfig& config);
     CC_Mqtt5ErrorCode addUserProp(const CC_Mqtt5UserProp& prop);
+    CC_Mqtt5ErrorCode configTemplate(
+        PublishTemplate& tmpl,
+        const unsigned char* data,
+        unsigned dataLen,
+        const unsigned char* correlationData,
+        unsigned correlationDataLen);
+    const PublishMsg& pubMsg() const;
     CC_Mqtt5ErrorCode setResendAttempts(unsigned attempts);
     unsigned getResendAttempts() const;
     CC_Mqtt5ErrorCode send(CC_Mqtt5PublishCompleteCb cb, void* cbData);
+    CC_Mqtt5ErrorCode sendTransient(CC_Mqtt5PublishCompleteCb cb, void* cbData);
     CC_Mqtt5ErrorCode cancel();
     void postReconnectionResend();
+    void acquireBufs(RecycledBufsList& bufs);
+    void releaseBufs(RecycledBufsList& bufs);
     void forceDupResend();
     bool resume();
     bool isPaused() const
@@ -88,10 +102,19 @@ public:
         return m_acked;
     }
 
+    unsigned sendOpsIdx() const
+    {
+        return m_sendOpsIdx;
+    }
+
+    void setSendOpsIdx(unsigned idx)
+    {
+        m_sendOpsIdx = idx;
+    }
+
 protected:
     virtual Type typeImpl() const override;
     virtual void terminateOpImpl(CC_Mqtt5AsyncOpStatus status) override;
-    virtual void connectivityChangedImpl() override;
 
 private:
     void restartResponseTimer();
@@ -99,27 +122,44 @@ private:
     void resendDupMsg();
     void completeWithCb(CC_Mqtt5AsyncOpStatus status, const CC_Mqtt5PublishResponse* response = nullptr);
     void confirmRegisteredAlias();
+    CC_Mqtt5ErrorCode configTopic(const char* topic, CC_Mqtt5TopicAliasPreference topicAliasPref);
+    CC_Mqtt5ErrorCode configPayload(const unsigned char* data, unsigned dataLen, bool borrowData);
     CC_Mqtt5ErrorCode doSendInternal();
+    CC_Mqtt5ErrorCode sendPublishMsg();
+    bool needsResponseProps(bool reported) const;
     bool canSend() const;
+    void releasePubMsg();
+    void releaseTemplate(bool keepMsg);
+    void releaseEncodedMsg();
     void opCompleteInternal();
 
     static void recvTimeoutCb(void* data);
 
-    TimerMgr::Timer m_responseTimer;
-    PublishMsg m_pubMsg;
+    ResponseTimeoutQueue::Timer m_responseTimer;
+    PubMsgAlloc::Ptr m_pubMsg; // Own message, released once serialized into m_encodedMsg
+    PublishMsg* m_msg = nullptr; // Message being sent: own, shared transient one, or the template's
+    PublishTemplate* m_tmpl = nullptr; // Template patched in place for the duration of the send call
+    EncodedMsgBuf m_encodedMsg; // Serialized m_pubMsg (without payload) kept for re-sends
+    EncodedMsgBuf m_payload; // Payload taken from m_pubMsg when serialized, not copied
+    const std::uint8_t* m_borrowedData = nullptr; // Application owned payload or m_payload
     CC_Mqtt5PublishCompleteCb m_cb = nullptr;
     void* m_cbData = nullptr;
+    unsigned m_borrowedDataLen = 0U;
     unsigned m_totalSendAttempts = DefaultSendAttempts;
     unsigned m_sendAttempts = 0U;
+    unsigned m_sendOpsIdx = 0U; // Index in the client's list of the send ops
     CC_Mqtt5ReasonCode m_reasonCode = CC_Mqtt5ReasonCode_Success;
+    std::uint16_t m_packetId = 0U;
+    Qos m_qos = Qos::AtMostOnceDelivery;
     bool m_published = false;
     bool m_acked = false;
     bool m_registeredAlias = false;
+    bool m_hasTopicAlias = false;
     bool m_topicConfigured = false;
     bool m_paused = false;
 
     static constexpr unsigned DefaultSendAttempts = 2U;
-    static_assert(ExtConfig::SendOpTimers == 1U);
+    static_assert(ExtConfig::SendOpTimers == 0U);
 };
 
 } // namespace op
@@ -46,7 +46,7 @@ constexpr unsigned reasonCodesLength()
 
 SubscribeOp::SubscribeOp(ClientImpl& client) :
     Base(client),
-    m_timer(client.timerMgr().allocTimer())
+    m_timer(client.responseTimeouts())
 {
 }
 
@@ -157,11 +157,6 @@ CC_Mqtt5ErrorCode SubscribeOp::send(CC_Mqtt5SubscribeCompleteCb cb, void* cbData
         return CC_Mqtt5ErrorCode_InsufficientConfig;
     }
 
-    if (!m_timer.isValid()) {
-        errorLog("The library cannot allocate required number of timers.");
-        return CC_Mqtt5ErrorCode_InternalError;
-    }
-
     m_cb = cb;
     m_cbData = cbData;
 
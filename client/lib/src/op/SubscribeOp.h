@@ -9,7 +9,7 @@
 
 #include "op/Op.h"
 #include "ProtocolDefs.h"
-#include "TimerMgr.h"
+#include "ResponseTimeoutQueue.h"
 
 namespace cc_mqtt5_client
 {
@@ -45,6 +45,11 @@ public:
         return reinterpret_cast<SubscribeOp*>(handle);
     }
 
+    unsigned packetId() const
+    {
+        return m_subMsg.field_packetId().value();
+    }
+
     using Base::handle;
     virtual void handle(SubackMsg& msg) override;
 
@@ -60,11 +65,11 @@ private:
     static void opTimeoutCb(void* data);
 
     SubscribeMsg m_subMsg;
-    TimerMgr::Timer m_timer;
+    ResponseTimeoutQueue::Timer m_timer;
     CC_Mqtt5SubscribeCompleteCb m_cb = nullptr;
     void* m_cbData = nullptr;
 
-    static_assert(ExtConfig::SubscribeOpTimers == 1U);
+    static_assert(ExtConfig::SubscribeOpTimers == 0U);
 };
 
 } // namespace op
@@ -46,7 +46,7 @@ constexpr unsigned reasonCodesLength()
 
 UnsubscribeOp::UnsubscribeOp(ClientImpl& client) :
     Base(client),
-    m_timer(client.timerMgr().allocTimer())
+    m_timer(client.responseTimeouts())
 {
 }
 
@@ -131,11 +131,6 @@ CC_Mqtt5ErrorCode UnsubscribeOp::send(CC_Mqtt5UnsubscribeCompleteCb cb, void* cb
         return CC_Mqtt5ErrorCode_InsufficientConfig;
     }
 
-    if (!m_timer.isValid()) {
-        errorLog("The library cannot allocate required number of timers.");
-        return CC_Mqtt5ErrorCode_InternalError;
-    }
-
     m_cb = cb;
     m_cbData = cbData;
 
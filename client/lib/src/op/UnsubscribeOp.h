@@ -9,7 +9,7 @@
 
 #include "op/Op.h"
 #include "ProtocolDefs.h"
-#include "TimerMgr.h"
+#include "ResponseTimeoutQueue.h"
 
 namespace cc_mqtt5_client
 {
@@ -44,6 +44,11 @@ public:
         return reinterpret_cast<UnsubscribeOp*>(handle);
     }
 
+    unsigned packetId() const
+    {
+        return m_unsubMsg.field_packetId().value();
+    }
+
     using Base::handle;
     virtual void handle(UnsubackMsg& msg) override;
 
@@ -59,11 +64,11 @@ private:
     static void opTimeoutCb(void* data);
 
     UnsubscribeMsg m_unsubMsg;
-    TimerMgr::Timer m_timer;
+    ResponseTimeoutQueue::Timer m_timer;
     CC_Mqtt5UnsubscribeCompleteCb m_cb = nullptr;
     void* m_cbData = nullptr;
 
-    static_assert(ExtConfig::UnsubscribeOpTimers == 1U);
+    static_assert(ExtConfig::UnsubscribeOpTimers == 0U);
 };
 
 } // namespace op
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "UnitTestPerfBase.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#define bench_assert(cond_) \
+    do { \
+        if (!(cond_)) { \
+            std::cerr << "\nAssertion failure (" << #cond_ << ") in " << __FILE__ << ":" << __LINE__ << std::endl; \
+            std::exit(1); \
+        } \
+    } while (false)
+
+class BenchPerfBase : public UnitTestPerfBase
+{
+public:
+    template <typename TFunc>
+    void benchRun(TFunc&& func)
+    {
+        unitTestSetUp();
+        func();
+        unitTestTearDown();
+    }
+
+protected:
+    using Clock = std::chrono::steady_clock;
+    using Duration = std::chrono::microseconds;
+
+    static UnitTestData benchSerialize(const UnitTestMessage& msg)
+    {
+        UnitTestsFrame frame;
+        UnitTestData data;
+        auto writeIter = std::back_inserter(data);
+        auto es = frame.write(msg, writeIter, data.max_size());
+        if (es == comms::ErrorStatus::UpdateRequired) {
+            auto* updateIter = &data[0];
+            es = frame.update(msg, updateIter, data.size());
+        }
+        bench_assert(es == comms::ErrorStatus::Success);
+        return data;
+    }
+
+    static long long benchUs(Clock::duration duration)
+    {
+        return static_cast<long long>(std::chrono::duration_cast<Duration>(duration).count());
+    }
+};
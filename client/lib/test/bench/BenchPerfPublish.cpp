@@ -0,0 +1,401 @@
+#include "BenchPerfBase.h"
+
+#include <vector>
+
+class BenchPerfPublish : public BenchPerfBase
+{
+public:
+    void benchSuback();
+    void benchPuback();
+    void benchPacketIdAlloc();
+    void benchFullOrdering();
+    void benchQos0Publish();
+    void benchQos1Cycle();
+
+private:
+    void benchPublishMany(CC_Mqtt5Client* client, unsigned count);
+};
+
+void BenchPerfPublish::benchPublishMany(CC_Mqtt5Client* client, unsigned count)
+{
+    const std::string Topic("some/topic");
+    const UnitTestData Data = { 0x1, 0x2, 0x3, 0x4, 0x5};
+
+    auto config = CC_Mqtt5PublishBasicConfig();
+    apiPublishInitConfigBasic(&config);
+    config.m_topic = Topic.c_str();
+    config.m_data = &Data[0];
+    config.m_dataLen = static_cast<decltype(config.m_dataLen)>(Data.size());
+    config.m_qos = CC_Mqtt5QoS_AtLeastOnceDelivery;
+
+    for (auto idx = 0U; idx < count; ++idx) {
+        auto* publish = apiPublishPrepare(client, nullptr);
+        bench_assert(publish != nullptr);
+
+        auto ec = apiPublishConfigBasic(publish, &config);
+        bench_assert(ec == CC_Mqtt5ErrorCode_Success);
+
+        ec = unitTestSendPublish(publish);
+        bench_assert(ec == CC_Mqtt5ErrorCode_Success);
+    }
+}
+
+void BenchPerfPublish::benchSuback()
+{
+    // Benchmark of SUBACK processing with many outstanding publishes
+    auto clientPtr = apiAllocClient();
+    auto* client = clientPtr.get();
+
+    unitTestPerformBasicConnect(client, __FUNCTION__);
+    bench_assert(apiIsConnected(client));
+
+    const unsigned PublishesCount = 10000U;
+    benchPublishMany(client, PublishesCount);
+    bench_assert(apiPublishCount(client) == PublishesCount);
+    unitTestClearState(true);
+
+    auto topicConfig = CC_Mqtt5SubscribeTopicConfig();
+    apiSubscribeInitConfigTopic(&topicConfig);
+    topicConfig.m_topic = "#";
+
+    const unsigned SubscribesCount = 1000U;
+    Clock::duration duration{};
+    for (auto idx = 0U; idx < SubscribesCount; ++idx) {
+        auto ec = apiSubscribeSimple(client, &topicConfig);
+        bench_assert(ec == CC_Mqtt5ErrorCode_Success);
+
+        auto sentMsg = unitTestGetSentMessage();
+        bench_assert(sentMsg);
+        bench_assert(sentMsg->getId() == cc_mqtt5::MsgId_Subscribe);
+        auto* subscribeMsg = dynamic_cast<UnitTestSubscribeMsg*>(sentMsg.get());
+        bench_assert(subscribeMsg != nullptr);
+
+        UnitTestSubackMsg subackMsg;
+        subackMsg.field_packetId().value() = subscribeMsg->field_packetId().value();
+        subackMsg.field_list().value().resize(1U);
+        subackMsg.field_list().value()[0].setValue(CC_Mqtt5ReasonCode_GrantedQos0);
+        auto subackData = benchSerialize(subackMsg);
+
+        auto startTime = Clock::now();
+        auto consumed = apiProcessData(client, subackData.data(), static_cast<unsigned>(subackData.size()));
+        duration += Clock::now() - startTime;
+        bench_assert(consumed == subackData.size());
+        bench_assert(unitTestIsSubscribeComplete());
+        unitTestPopSubscribeResponseInfo();
+    }
+
+    bench_assert(apiPublishCount(client) == PublishesCount);
+    bench_assert(!unitTestIsDisconnected());
+
+    std::cout << __FUNCTION__ << ": " << SubscribesCount << " SUBACK messages with " << PublishesCount <<
+        " outstanding publishes: " << benchUs(duration) << "us" << std::endl;
+}
+
+void BenchPerfPublish::benchPuback()
+{
+    // Benchmark of PUBACK processing with many outstanding publishes
+    auto clientPtr = apiAllocClient();
+    auto* client = clientPtr.get();
+
+    unitTestPerformBasicConnect(client, __FUNCTION__);
+    bench_assert(apiIsConnected(client));
+
+    const unsigned PublishesCount = 10000U;
+    benchPublishMany(client, PublishesCount);
+    bench_assert(apiPublishCount(client) == PublishesCount);
+
+    std::vector<UnitTestData> pubackFrames;
+    pubackFrames.reserve(PublishesCount);
+    while (unitTestHasSentMessage()) {
+        auto sentMsg = unitTestGetSentMessage();
+        bench_assert(sentMsg);
+        bench_assert(sentMsg->getId() == cc_mqtt5::MsgId_Publish);
+        auto* publishMsg = dynamic_cast<UnitTestPublishMsg*>(sentMsg.get());
+        bench_assert(publishMsg != nullptr);
+
+        UnitTestPubackMsg pubackMsg;
+        pubackMsg.field_packetId().value() = publishMsg->field_packetId().field().value();
+        pubackFrames.push_back(benchSerialize(pubackMsg));
+    }
+    bench_assert(pubackFrames.size() == PublishesCount);
+    unitTestClearState(true);
+
+    auto startTime = Clock::now();
+    for (auto& frame : pubackFrames) {
+        auto consumed = apiProcessData(client, frame.data(), static_cast<unsigned>(frame.size()));
+        bench_assert(consumed == frame.size());
+    }
+    auto duration = Clock::now() - startTime;
+
+    bench_assert(apiPublishCount(client) == 0U);
+    for (auto idx = 0U; idx < PublishesCount; ++idx) {
+        bench_assert(unitTestIsPublishComplete());
+        bench_assert(unitTestPublishResponseInfo().m_status == CC_Mqtt5AsyncOpStatus_Complete);
+        unitTestPopPublishResponseInfo();
+    }
+    bench_assert(!unitTestIsDisconnected());
+
+    std::cout << __FUNCTION__ << ": " << PublishesCount << " PUBACK messages: " <<
+        benchUs(duration) << "us" << std::endl;
+}
+
+void BenchPerfPublish::benchPacketIdAlloc()
+{
+    // Benchmark of packet ID allocation with almost all the IDs in use
+    auto clientPtr = apiAllocClient();
+    auto* client = clientPtr.get();
+
+    unitTestPerformBasicConnect(client, __FUNCTION__);
+    bench_assert(apiIsConnected(client));
+
+    const unsigned PublishesCount = 60000U;
+    auto startTime = Clock::now();
+    benchPublishMany(client, PublishesCount);
+    auto duration = Clock::now() - startTime;
+    bench_assert(apiPublishCount(client) == PublishesCount);
+
+    unsigned expectedPacketId = 1U;
+    while (unitTestHasSentMessage()) {
+        auto sentMsg = unitTestGetSentMessage();
+        bench_assert(sentMsg);
+        bench_assert(sentMsg->getId() == cc_mqtt5::MsgId_Publish);
+        auto* publishMsg = dynamic_cast<UnitTestPublishMsg*>(sentMsg.get());
+        bench_assert(publishMsg != nullptr);
+        bench_assert(publishMsg->field_packetId().field().value() == expectedPacketId);
+        ++expectedPacketId;
+    }
+    bench_assert(expectedPacketId == PublishesCount + 1U);
+    bench_assert(!unitTestIsDisconnected());
+
+    std::cout << __FUNCTION__ << ": " << PublishesCount << " outstanding QoS1 publishes: " <<
+        benchUs(duration) << "us" << std::endl;
+}
+
+void BenchPerfPublish::benchFullOrdering()
+{
+    // Benchmark of full ordering publishing with many queued publishes
+    auto clientPtr = apiAllocClient();
+    auto* client = clientPtr.get();
+
+    auto ec = apiPublishSetOrdering(client, CC_Mqtt5PublishOrdering_Full);
+    bench_assert(ec == CC_Mqtt5ErrorCode_Success);
+
+    auto basicConfig = CC_Mqtt5ConnectBasicConfig();
+    apiConnectInitConfigBasic(&basicConfig);
+    basicConfig.m_clientId = __FUNCTION__;
+    basicConfig.m_cleanStart = true;
+
+    UnitTestConnectResponseConfig responseConfig;
+    responseConfig.m_recvMaximum = 10;
+
+    unitTestPerformConnect(client, &basicConfig, nullptr, nullptr, nullptr, &responseConfig);
+    bench_assert(apiIsConnected(client));
+
+    const std::string Topic("some/topic");
+    const UnitTestData Data = { 0x1, 0x2, 0x3, 0x4, 0x5};
+
+    auto config = CC_Mqtt5PublishBasicConfig();
+    apiPublishInitConfigBasic(&config);
+    config.m_topic = Topic.c_str();
+    config.m_data = &Data[0];
+    config.m_dataLen = static_cast<decltype(config.m_dataLen)>(Data.size());
+
+    // QoS0 publishes are queued behind the QoS1 ones
+    const unsigned PublishesCount = 5000U;
+    auto startTime = Clock::now();
+    for (auto idx = 0U; idx < PublishesCount; ++idx) {
+        config.m_qos = ((idx % 2U) == 0U) ? CC_Mqtt5QoS_AtLeastOnceDelivery : CC_Mqtt5QoS_AtMostOnceDelivery;
+
+        auto* publish = apiPublishPrepare(client, nullptr);
+        bench_assert(publish != nullptr);
+
+        ec = apiPublishConfigBasic(publish, &config);
+        bench_assert(ec == CC_Mqtt5ErrorCode_Success);
+
+        ec = unitTestSendPublish(publish);
+        bench_assert(ec == CC_Mqtt5ErrorCode_Success);
+    }
+    auto publishDuration = Clock::now() - startTime;
+    bench_assert(apiPublishCount(client) == PublishesCount);
+
+    unsigned publishedCount = 0U;
+    startTime = Clock::now();
+    while (unitTestHasSentMessage()) {
+        auto sentMsg = unitTestGetSentMessage();
+        bench_assert(sentMsg);
+        bench_assert(sentMsg->getId() == cc_mqtt5::MsgId_Publish);
+        auto* publishMsg = dynamic_cast<UnitTestPublishMsg*>(sentMsg.get());
+        bench_assert(publishMsg != nullptr);
+        ++publishedCount;
+
+        if (static_cast<CC_Mqtt5QoS>(publishMsg->transportField_flags().field_qos().value()) == CC_Mqtt5QoS_AtMostOnceDelivery) {
+            continue;
+        }
+
+        UnitTestPubackMsg pubackMsg;
+        pubackMsg.field_packetId().value() = publishMsg->field_packetId().field().value();
+        auto pubackData = benchSerialize(pubackMsg);
+        auto consumed = apiProcessData(client, pubackData.data(), static_cast<unsigned>(pubackData.size()));
+        bench_assert(consumed == pubackData.size());
+    }
+    auto ackDuration = Clock::now() - startTime;
+
+    bench_assert(publishedCount == PublishesCount);
+    bench_assert(apiPublishCount(client) == 0U);
+    bench_assert(!unitTestIsDisconnected());
+
+    std::cout << __FUNCTION__ << ": " << PublishesCount << " publishes with full ordering: queuing=" <<
+        benchUs(publishDuration) << "us, acking=" <<
+        benchUs(ackDuration) << "us" << std::endl;
+}
+
+void BenchPerfPublish::benchQos0Publish()
+{
+    // Benchmark of QoS0 publishing using the prepared publish, template and batch
+    auto clientPtr = apiAllocClient();
+    auto* client = clientPtr.get();
+
+    unitTestPerformBasicConnect(client, __FUNCTION__);
+    bench_assert(apiIsConnected(client));
+
+    const std::string Topic("some/topic");
+    const UnitTestData Data = { 0x1, 0x2, 0x3, 0x4, 0x5};
+
+    auto config = CC_Mqtt5PublishBasicConfig();
+    apiPublishInitConfigBasic(&config);
+    config.m_topic = Topic.c_str();
+    config.m_data = &Data[0];
+    config.m_dataLen = static_cast<decltype(config.m_dataLen)>(Data.size());
+    config.m_qos = CC_Mqtt5QoS_AtMostOnceDelivery;
+
+    auto checkAllSent =
+        [this](unsigned count)
+        {
+            unsigned sentCount = 0U;
+            while (unitTestHasSentMessage()) {
+                auto sentMsg = unitTestGetSentMessage();
+                bench_assert(sentMsg);
+                bench_assert(sentMsg->getId() == cc_mqtt5::MsgId_Publish);
+                ++sentCount;
+            }
+            bench_assert(sentCount == count);
+
+            for (auto idx = 0U; idx < count; ++idx) {
+                bench_assert(unitTestIsPublishComplete());
+                bench_assert(unitTestPublishResponseInfo().m_status == CC_Mqtt5AsyncOpStatus_Complete);
+                unitTestPopPublishResponseInfo();
+            }
+        };
+
+    const unsigned PublishesCount = 10000U;
+    auto startTime = Clock::now();
+    for (auto idx = 0U; idx < PublishesCount; ++idx) {
+        auto* publish = apiPublishPrepare(client, nullptr);
+        bench_assert(publish != nullptr);
+
+        auto ec = apiPublishConfigBasic(publish, &config);
+        bench_assert(ec == CC_Mqtt5ErrorCode_Success);
+
+        ec = unitTestSendPublish(publish);
+        bench_assert(ec == CC_Mqtt5ErrorCode_Success);
+    }
+    auto prepareDuration = Clock::now() - startTime;
+    checkAllSent(PublishesCount);
+
+    auto ec = CC_Mqtt5ErrorCode_Success;
+    auto* tmpl = apiPublishTemplateAlloc(client, &config, nullptr, nullptr, 0U, &ec);
+    bench_assert(tmpl != nullptr);
+
+    startTime = Clock::now();
+    for (auto idx = 0U; idx < PublishesCount; ++idx) {
+        ec = unitTestSendPublishTemplate(client, tmpl, Data);
+        bench_assert(ec == CC_Mqtt5ErrorCode_Success);
+    }
+    auto templateDuration = Clock::now() - startTime;
+    checkAllSent(PublishesCount);
+
+    std::vector<CC_Mqtt5PublishBasicConfig> configs(PublishesCount, config);
+    unsigned sentCount = 0U;
+    startTime = Clock::now();
+    ec = unitTestSendPublishBatch(client, configs.data(), nullptr, PublishesCount, &sentCount);
+    auto batchDuration = Clock::now() - startTime;
+    bench_assert(ec == CC_Mqtt5ErrorCode_Success);
+    bench_assert(sentCount == PublishesCount);
+    checkAllSent(PublishesCount);
+
+    bench_assert(apiPublishCount(client) == 0U);
+    bench_assert(!unitTestIsDisconnected());
+
+    std::cout << __FUNCTION__ << ": " << PublishesCount << " QoS0 publishes: prepared=" <<
+        benchUs(prepareDuration) << "us, template=" <<
+        benchUs(templateDuration) << "us, batch=" <<
+        benchUs(batchDuration) << "us" << std::endl;
+}
+
+void BenchPerfPublish::benchQos1Cycle()
+{
+    // Benchmark of the steady-state QoS1 publish / acknowledge loop,
+    // the completed operations are recycled when CC_MQTT5_CLIENT_RECYCLED_OBJS_LIMIT is set.
+    auto clientPtr = apiAllocClient();
+    auto* client = clientPtr.get();
+
+    unitTestPerformBasicConnect(client, __FUNCTION__);
+    bench_assert(apiIsConnected(client));
+
+    const std::string Topic("some/topic");
+    const UnitTestData Data(64U, 0x5a);
+
+    auto config = CC_Mqtt5PublishBasicConfig();
+    apiPublishInitConfigBasic(&config);
+    config.m_topic = Topic.c_str();
+    config.m_data = &Data[0];
+    config.m_dataLen = static_cast<decltype(config.m_dataLen)>(Data.size());
+    config.m_qos = CC_Mqtt5QoS_AtLeastOnceDelivery;
+
+    const unsigned PublishesCount = 10000U;
+    auto startTime = Clock::now();
+    for (auto idx = 0U; idx < PublishesCount; ++idx) {
+        auto* publish = apiPublishPrepare(client, nullptr);
+        bench_assert(publish != nullptr);
+
+        auto ec = apiPublishConfigBasic(publish, &config);
+        bench_assert(ec == CC_Mqtt5ErrorCode_Success);
+
+        ec = unitTestSendPublish(publish);
+        bench_assert(ec == CC_Mqtt5ErrorCode_Success);
+
+        auto sentMsg = unitTestGetSentMessage();
+        bench_assert(sentMsg);
+        auto* publishMsg = dynamic_cast<UnitTestPublishMsg*>(sentMsg.get());
+        bench_assert(publishMsg != nullptr);
+
+        UnitTestPubackMsg pubackMsg;
+        pubackMsg.field_packetId().value() = publishMsg->field_packetId().field().value();
+        auto pubackData = benchSerialize(pubackMsg);
+        auto consumed = apiProcessData(client, pubackData.data(), static_cast<unsigned>(pubackData.size()));
+        bench_assert(consumed == pubackData.size());
+
+        bench_assert(unitTestIsPublishComplete());
+        bench_assert(unitTestPublishResponseInfo().m_status == CC_Mqtt5AsyncOpStatus_Complete);
+        unitTestPopPublishResponseInfo();
+    }
+    auto duration = Clock::now() - startTime;
+
+    bench_assert(apiPublishCount(client) == 0U);
+    bench_assert(!unitTestIsDisconnected());
+
+    std::cout << __FUNCTION__ << ": " << PublishesCount << " QoS1 publish / PUBACK cycles: " <<
+        benchUs(duration) << "us" << std::endl;
+}
+
+int main()
+{
+    BenchPerfPublish bench;
+    bench.benchRun([&bench]() { bench.benchSuback(); });
+    bench.benchRun([&bench]() { bench.benchPuback(); });
+    bench.benchRun([&bench]() { bench.benchPacketIdAlloc(); });
+    bench.benchRun([&bench]() { bench.benchFullOrdering(); });
+    bench.benchRun([&bench]() { bench.benchQos0Publish(); });
+    bench.benchRun([&bench]() { bench.benchQos1Cycle(); });
+    return 0;
+}
@@ -0,0 +1,154 @@
+#include "BenchPerfBase.h"
+
+#include <algorithm>
+#include <cstdint>
+
+class BenchPerfReceive : public BenchPerfBase
+{
+public:
+    void benchPublishFrames();
+    void benchQos2Receive();
+
+private:
+    struct BenchRecvDataInfo
+    {
+        UnitTestData m_data;
+        unsigned m_count = 0U;
+    };
+
+    static void benchRecvDataInfoCb(void* data, const CC_Mqtt5MessageInfo* info);
+};
+
+void BenchPerfReceive::benchRecvDataInfoCb(void* data, const CC_Mqtt5MessageInfo* info)
+{
+    auto* recvInfo = reinterpret_cast<BenchRecvDataInfo*>(data);
+    recvInfo->m_data.assign(info->m_data, info->m_data + info->m_dataLen);
+    ++recvInfo->m_count;
+}
+
+void BenchPerfReceive::benchPublishFrames()
+{
+    // Benchmark of processing many small back-to-back PUBLISH frames
+    // reported as a whole and in small segments.
+    auto clientPtr = apiAllocClient();
+    auto* client = clientPtr.get();
+
+    unitTestPerformBasicConnect(client, __FUNCTION__);
+    bench_assert(apiIsConnected(client));
+
+    unitTestPerformBasicSubscribe(client, "#");
+
+    BenchRecvDataInfo recvInfo;
+    apiSetMessageReceivedReportCb(client, &BenchPerfReceive::benchRecvDataInfoCb, &recvInfo);
+
+    UnitTestPublishMsg publishMsg;
+    publishMsg.field_topic().value() = "a/b";
+    publishMsg.field_payload().value() = UnitTestData(16U, 0x5a);
+    publishMsg.doRefresh();
+    auto publishData = benchSerialize(publishMsg);
+
+    const unsigned FramesCount = 10000U;
+    UnitTestData buf;
+    buf.reserve(publishData.size() * FramesCount);
+    for (auto idx = 0U; idx < FramesCount; ++idx) {
+        buf.insert(buf.end(), publishData.begin(), publishData.end());
+    }
+
+    auto startTime = Clock::now();
+    auto consumed = apiProcessData(client, buf.data(), static_cast<unsigned>(buf.size()));
+    auto wholeDuration = Clock::now() - startTime;
+    bench_assert(consumed == buf.size());
+    bench_assert(recvInfo.m_count == FramesCount);
+
+    // Emulating reception of the data in small TCP segments,
+    // the unconsumed data is reported again together with the new segment.
+    const std::size_t SegmentSize = 3U;
+    recvInfo.m_count = 0U;
+    std::size_t reportedEnd = 0U;
+    std::size_t consumedTotal = 0U;
+    startTime = Clock::now();
+    while (reportedEnd < buf.size()) {
+        reportedEnd = std::min(reportedEnd + SegmentSize, buf.size());
+        consumedTotal += apiProcessData(client, buf.data() + consumedTotal, static_cast<unsigned>(reportedEnd - consumedTotal));
+    }
+    auto segmentedDuration = Clock::now() - startTime;
+    bench_assert(consumedTotal == buf.size());
+    bench_assert(recvInfo.m_count == FramesCount);
+    bench_assert(!unitTestIsDisconnected());
+
+    std::cout << __FUNCTION__ << ": " << FramesCount << " PUBLISH frames of " << publishData.size() << " bytes: whole buffer=" <<
+        benchUs(wholeDuration) << "us, " << SegmentSize << " byte segments=" <<
+        benchUs(segmentedDuration) << "us" << std::endl;
+}
+
+void BenchPerfReceive::benchQos2Receive()
+{
+    // Benchmark of many outstanding QoS2 receptions waiting for PUBREL
+    auto clientPtr = apiAllocClient();
+    auto* client = clientPtr.get();
+
+    unitTestPerformBasicConnect(client, __FUNCTION__);
+    bench_assert(apiIsConnected(client));
+
+    unitTestPerformBasicSubscribe(client, "#");
+
+    BenchRecvDataInfo recvInfo;
+    apiSetMessageReceivedReportCb(client, &BenchPerfReceive::benchRecvDataInfoCb, &recvInfo);
+
+    const unsigned PublishesCount = 10000U;
+    UnitTestData publishBuf;
+    UnitTestData pubrelBuf;
+    for (auto idx = 0U; idx < PublishesCount; ++idx) {
+        auto packetId = static_cast<std::uint16_t>(idx + 1U);
+        UnitTestPublishMsg publishMsg;
+        publishMsg.transportField_flags().field_qos().value() = UnitTestPublishMsg::TransportField_flags::Field_qos::ValueType::ExactlyOnceDelivery;
+        publishMsg.field_packetId().field().setValue(packetId);
+        publishMsg.field_topic().value() = "a/b";
+        publishMsg.field_payload().value() = UnitTestData(16U, 0x5a);
+        publishMsg.doRefresh();
+        auto publishData = benchSerialize(publishMsg);
+        publishBuf.insert(publishBuf.end(), publishData.begin(), publishData.end());
+
+        UnitTestPubrelMsg pubrelMsg;
+        pubrelMsg.field_packetId().setValue(packetId);
+        auto pubrelData = benchSerialize(pubrelMsg);
+        pubrelBuf.insert(pubrelBuf.end(), pubrelData.begin(), pubrelData.end());
+    }
+
+    auto startTime = Clock::now();
+    auto consumed = apiProcessData(client, publishBuf.data(), static_cast<unsigned>(publishBuf.size()));
+    auto publishDuration = Clock::now() - startTime;
+    bench_assert(consumed == publishBuf.size());
+    bench_assert(recvInfo.m_count == PublishesCount);
+
+    for (auto idx = 0U; idx < PublishesCount; ++idx) {
+        auto sentMsg = unitTestGetSentMessage();
+        bench_assert(sentMsg);
+        bench_assert(sentMsg->getId() == cc_mqtt5::MsgId_Pubrec);
+    }
+
+    startTime = Clock::now();
+    consumed = apiProcessData(client, pubrelBuf.data(), static_cast<unsigned>(pubrelBuf.size()));
+    auto pubrelDuration = Clock::now() - startTime;
+    bench_assert(consumed == pubrelBuf.size());
+
+    for (auto idx = 0U; idx < PublishesCount; ++idx) {
+        auto sentMsg = unitTestGetSentMessage();
+        bench_assert(sentMsg);
+        bench_assert(sentMsg->getId() == cc_mqtt5::MsgId_Pubcomp);
+    }
+
+    bench_assert(!unitTestIsDisconnected());
+
+    std::cout << __FUNCTION__ << ": " << PublishesCount << " outstanding QoS2 receptions: PUBLISH=" <<
+        benchUs(publishDuration) << "us, PUBREL=" <<
+        benchUs(pubrelDuration) << "us" << std::endl;
+}
+
+int main()
+{
+    BenchPerfReceive bench;
+    bench.benchRun([&bench]() { bench.benchPublishFrames(); });
+    bench.benchRun([&bench]() { bench.benchQos2Receive(); });
+    return 0;
+}
@@ -42,8 +42,19 @@ UnitTestCommonBase::UnitTestCommonBase(const LibFuncs& funcs) :
     test_assert(m_funcs.m_free != nullptr);
     test_assert(m_funcs.m_tick != nullptr);
     test_assert(m_funcs.m_process_data != nullptr);
+    test_assert(m_funcs.m_process_data_v != nullptr);
     test_assert(m_funcs.m_notify_network_disconnected != nullptr);
     test_assert(m_funcs.m_is_network_disconnected != nullptr);
+    test_assert(m_funcs.m_set_incremental_recv_enabled != nullptr);
+    test_assert(m_funcs.m_get_incremental_recv_enabled != nullptr);
+    test_assert(m_funcs.m_set_lazy_props_enabled != nullptr);
+    test_assert(m_funcs.m_get_lazy_props_enabled != nullptr);
+    test_assert(m_funcs.m_fetch_user_props != nullptr);
+    test_assert(m_funcs.m_set_auto_cork_enabled != nullptr);
+    test_assert(m_funcs.m_get_auto_cork_enabled != nullptr);
+    test_assert(m_funcs.m_cork != nullptr);
+    test_assert(m_funcs.m_uncork != nullptr);
+    test_assert(m_funcs.m_is_corked != nullptr);
     test_assert(m_funcs.m_set_default_response_timeout != nullptr);
     test_assert(m_funcs.m_get_default_response_timeout != nullptr);
     test_assert(m_funcs.m_pub_topic_alias_alloc != nullptr);
@@ -121,8 +132,12 @@ UnitTestCommonBase::UnitTestCommonBase(const LibFuncs& funcs) :
     test_assert(m_funcs.m_publish_was_initiated != nullptr);
     test_assert(m_funcs.m_publish_simple != nullptr);
     test_assert(m_funcs.m_publish_full != nullptr);
+    test_assert(m_funcs.m_publish_batch != nullptr);
     test_assert(m_funcs.m_publish_set_ordering != nullptr);
     test_assert(m_funcs.m_publish_get_ordering != nullptr);
+    test_assert(m_funcs.m_publish_template_alloc != nullptr);
+    test_assert(m_funcs.m_publish_template_free != nullptr);
+    test_assert(m_funcs.m_publish_template_send != nullptr);
     test_assert(m_funcs.m_reauth_prepare != nullptr);
     test_assert(m_funcs.m_reauth_init_config_auth != nullptr);
     test_assert(m_funcs.m_reauth_set_response_timeout != nullptr);
@@ -135,8 +150,11 @@ UnitTestCommonBase::UnitTestCommonBase(const LibFuncs& funcs) :
     test_assert(m_funcs.m_set_next_tick_program_callback != nullptr);
     test_assert(m_funcs.m_set_cancel_next_tick_wait_callback != nullptr);
     test_assert(m_funcs.m_set_send_output_data_callback != nullptr);
+    test_assert(m_funcs.m_set_send_output_data_v_callback != nullptr);
+    test_assert(m_funcs.m_set_output_buf_provider_callbacks != nullptr);
     test_assert(m_funcs.m_set_broker_disconnect_report_callback != nullptr);
     test_assert(m_funcs.m_set_message_received_report_callback != nullptr);
+    test_assert(m_funcs.m_set_messages_received_report_callback != nullptr);
     test_assert(m_funcs.m_set_error_log_callback != nullptr);
 }
 
@@ -327,6 +345,35 @@ CC_Mqtt5ErrorCode UnitTestCommonBase::unitTestSendPublish(CC_Mqtt5PublishHandle&
     return result;
 }
 
+CC_Mqtt5ErrorCode UnitTestCommonBase::unitTestSendPublishBatch(
+    CC_Mqtt5ClientHandle handle,
+    const CC_Mqtt5PublishBasicConfig* basicConfigs,
+    const CC_Mqtt5PublishExtraConfig* extraConfigs,
+    unsigned count,
+    unsigned* sentCount)
+{
+    return m_funcs.m_publish_batch(handle, basicConfigs, extraConfigs, count, &UnitTestCommonBase::unitTestPublishCompleteCb, this, sentCount);
+}
+
+CC_Mqtt5ErrorCode UnitTestCommonBase::unitTestSendPublishTemplate(CC_Mqtt5ClientHandle handle, CC_Mqtt5PublishTemplateHandle tmpl, const UnitTestData& data, const UnitTestData& correlationData)
+{
+    const unsigned char* correlationDataPtr = nullptr;
+    if (!correlationData.empty()) {
+        correlationDataPtr = correlationData.data();
+    }
+
+    return
+        m_funcs.m_publish_template_send(
+            handle,
+            tmpl,
+            data.data(),
+            static_cast<unsigned>(data.size()),
+            correlationDataPtr,
+            static_cast<unsigned>(correlationData.size()),
+            &UnitTestCommonBase::unitTestPublishCompleteCb,
+            this);
+}
+
 CC_Mqtt5ErrorCode UnitTestCommonBase::unitTestSendReauth(CC_Mqtt5ReauthHandle& reauth)
 {
     auto result = m_funcs.m_reauth_send(reauth, &UnitTestCommonBase::unitTestReauthCompleteCb, this);
@@ -930,6 +977,7 @@ void UnitTestCommonBase::unitTestClearState(bool preserveTicks)
         m_tickReq.clear();
     }
     m_sentData.clear();
+    m_sentDataReportsCount = 0U;
     m_receivedData.clear();
     m_connectResp.clear();
     m_subscribeResp.clear();
@@ -947,6 +995,16 @@ UnitTestCommonBase::UnitTestClientPtr UnitTestCommonBase::apiAlloc()
     return UnitTestClientPtr(m_funcs.m_alloc(), UnitTestDeleter(m_funcs));
 }
 
+unsigned UnitTestCommonBase::apiProcessData(CC_Mqtt5Client* client, const unsigned char* buf, unsigned bufLen)
+{
+    return m_funcs.m_process_data(client, buf, bufLen);
+}
+
+unsigned UnitTestCommonBase::apiProcessDataV(CC_Mqtt5Client* client, const CC_Mqtt5DataSegment* segments, unsigned count)
+{
+    return m_funcs.m_process_data_v(client, segments, count);
+}
+
 void UnitTestCommonBase::apiNotifyNetworkDisconnected(CC_Mqtt5Client* client)
 {
     m_funcs.m_notify_network_disconnected(client);
@@ -957,6 +1015,56 @@ bool UnitTestCommonBase::apiIsNetworkDisconnected(CC_Mqtt5Client* client)
     return m_funcs.m_is_network_disconnected(client);
 }
 
+CC_Mqtt5ErrorCode UnitTestCommonBase::apiSetIncrementalRecvEnabled(CC_Mqtt5Client* client, bool enabled)
+{
+    return m_funcs.m_set_incremental_recv_enabled(client, enabled);
+}
+
+bool UnitTestCommonBase::apiGetIncrementalRecvEnabled(CC_Mqtt5Client* client)
+{
+    return m_funcs.m_get_incremental_recv_enabled(client);
+}
+
+CC_Mqtt5ErrorCode UnitTestCommonBase::apiSetLazyPropsEnabled(CC_Mqtt5Client* client, bool enabled)
+{
+    return m_funcs.m_set_lazy_props_enabled(client, enabled);
+}
+
+bool UnitTestCommonBase::apiGetLazyPropsEnabled(CC_Mqtt5Client* client)
+{
+    return m_funcs.m_get_lazy_props_enabled(client);
+}
+
+CC_Mqtt5ErrorCode UnitTestCommonBase::apiFetchUserProps(CC_Mqtt5Client* client, CC_Mqtt5LazyUserPropsHandle lazyProps, const CC_Mqtt5UserProp** props, unsigned* count)
+{
+    return m_funcs.m_fetch_user_props(client, lazyProps, props, count);
+}
+
+CC_Mqtt5ErrorCode UnitTestCommonBase::apiSetAutoCorkEnabled(CC_Mqtt5Client* client, bool enabled)
+{
+    return m_funcs.m_set_auto_cork_enabled(client, enabled);
+}
+
+bool UnitTestCommonBase::apiGetAutoCorkEnabled(CC_Mqtt5Client* client)
+{
+    return m_funcs.m_get_auto_cork_enabled(client);
+}
+
+void UnitTestCommonBase::apiCork(CC_Mqtt5Client* client)
+{
+    m_funcs.m_cork(client);
+}
+
+void UnitTestCommonBase::apiUncork(CC_Mqtt5Client* client)
+{
+    m_funcs.m_uncork(client);
+}
+
+bool UnitTestCommonBase::apiIsCorked(CC_Mqtt5Client* client)
+{
+    return m_funcs.m_is_corked(client);
+}
+
 CC_Mqtt5ErrorCode UnitTestCommonBase::apiSetDefaultResponseTimeout(CC_Mqtt5Client* client, unsigned ms)
 {
     return m_funcs.m_set_default_response_timeout(client, ms);
@@ -1177,6 +1285,35 @@ CC_Mqtt5PublishOrdering UnitTestCommonBase::apiPublishGetOrdering(CC_Mqtt5Client
     return m_funcs.m_publish_get_ordering(handle);
 }
 
+CC_Mqtt5PublishTemplateHandle UnitTestCommonBase::apiPublishTemplateAlloc(
+    CC_Mqtt5ClientHandle handle,
+    const CC_Mqtt5PublishBasicConfig* basic,
+    const CC_Mqtt5PublishExtraConfig* extra,
+    const CC_Mqtt5UserProp* userProps,
+    unsigned userPropsCount,
+    CC_Mqtt5ErrorCode* ec)
+{
+    return m_funcs.m_publish_template_alloc(handle, basic, extra, userProps, userPropsCount, ec);
+}
+
+CC_Mqtt5ErrorCode UnitTestCommonBase::apiPublishTemplateFree(CC_Mqtt5ClientHandle handle, CC_Mqtt5PublishTemplateHandle tmpl)
+{
+    return m_funcs.m_publish_template_free(handle, tmpl);
+}
+
+CC_Mqtt5ErrorCode UnitTestCommonBase::apiPublishTemplateSend(
+    CC_Mqtt5ClientHandle handle,
+    CC_Mqtt5PublishTemplateHandle tmpl,
+    const unsigned char* data,
+    unsigned dataLen,
+    const unsigned char* correlationData,
+    unsigned correlationDataLen,
+    CC_Mqtt5PublishCompleteCb cb,
+    void* cbData)
+{
+    return m_funcs.m_publish_template_send(handle, tmpl, data, dataLen, correlationData, correlationDataLen, cb, cbData);
+}
+
 CC_Mqtt5ReauthHandle UnitTestCommonBase::apiReauthPrepare(CC_Mqtt5Client* client, CC_Mqtt5ErrorCode* ec)
 {
     return m_funcs.m_reauth_prepare(client, ec);
@@ -1207,6 +1344,16 @@ void UnitTestCommonBase::apiSetSendOutputDataCb(CC_Mqtt5ClientHandle handle, CC_
     return m_funcs.m_set_send_output_data_callback(handle, cb, data);
 }
 
+void UnitTestCommonBase::apiSetSendOutputDataVCb(CC_Mqtt5ClientHandle handle, CC_Mqtt5SendOutputDataVCb cb, void* data)
+{
+    return m_funcs.m_set_send_output_data_v_callback(handle, cb, data);
+}
+
+CC_Mqtt5ErrorCode UnitTestCommonBase::apiSetOutputBufProviderCbs(CC_Mqtt5ClientHandle handle, CC_Mqtt5OutputBufReserveCb reserveCb, CC_Mqtt5OutputBufCommitCb commitCb, void* data)
+{
+    return m_funcs.m_set_output_buf_provider_callbacks(handle, reserveCb, commitCb, data);
+}
+
 void UnitTestCommonBase::apiSetBrokerDisconnectReportCb(CC_Mqtt5ClientHandle handle, CC_Mqtt5BrokerDisconnectReportCb cb, void* data)
 {
     return m_funcs.m_set_broker_disconnect_report_callback(handle, cb, data);
@@ -1217,6 +1364,11 @@ void UnitTestCommonBase::apiSetMessageReceivedReportCb(CC_Mqtt5ClientHandle hand
     return m_funcs.m_set_message_received_report_callback(handle, cb, data);
 }
 
+CC_Mqtt5ErrorCode UnitTestCommonBase::apiSetMessagesReceivedReportCb(CC_Mqtt5ClientHandle handle, CC_Mqtt5MessagesReceivedReportCb cb, void* data)
+{
+    return m_funcs.m_set_messages_received_report_callback(handle, cb, data);
+}
+
 void UnitTestCommonBase::unitTestErrorLogCb([[maybe_unused]] void* obj, const char* msg)
 {
     std::cout << "ERROR: " << msg << std::endl;
@@ -1246,6 +1398,7 @@ void UnitTestCommonBase::unitTestSendOutputDataCb(void* obj, const unsigned char
 {
     auto* realObj = reinterpret_cast<UnitTestCommonBase*>(obj);
     std::copy_n(buf, bufLen, std::back_inserter(realObj->m_sentData));
+    ++realObj->m_sentDataReportsCount;
 }
 
 void UnitTestCommonBase::unitTestProgramNextTickCb(void* obj, unsigned duration)
@@ -23,8 +23,19 @@ public:
         void (*m_free)(CC_Mqtt5ClientHandle) = nullptr;
         void (*m_tick)(CC_Mqtt5ClientHandle, unsigned) = nullptr;
         unsigned (*m_process_data)(CC_Mqtt5ClientHandle, const unsigned char*, unsigned) = nullptr;
+        unsigned (*m_process_data_v)(CC_Mqtt5ClientHandle, const CC_Mqtt5DataSegment*, unsigned) = nullptr;
         void (*m_notify_network_disconnected)(CC_Mqtt5ClientHandle) = nullptr;
         bool (*m_is_network_disconnected)(CC_Mqtt5ClientHandle) = nullptr;
+        CC_Mqtt5ErrorCode (*m_set_incremental_recv_enabled)(CC_Mqtt5ClientHandle, bool) = nullptr;
+        bool (*m_get_incremental_recv_enabled)(CC_Mqtt5ClientHandle) = nullptr;
+        CC_Mqtt5ErrorCode (*m_set_lazy_props_enabled)(CC_Mqtt5ClientHandle, bool) = nullptr;
+        bool (*m_get_lazy_props_enabled)(CC_Mqtt5ClientHandle) = nullptr;
+        CC_Mqtt5ErrorCode (*m_fetch_user_props)(CC_Mqtt5ClientHandle, CC_Mqtt5LazyUserPropsHandle, const CC_Mqtt5UserProp**, unsigned*) = nullptr;
+        CC_Mqtt5ErrorCode (*m_set_auto_cork_enabled)(CC_Mqtt5ClientHandle, bool) = nullptr;
+        bool (*m_get_auto_cork_enabled)(CC_Mqtt5ClientHandle) = nullptr;
+        void (*m_cork)(CC_Mqtt5ClientHandle) = nullptr;
+        void (*m_uncork)(CC_Mqtt5ClientHandle) = nullptr;
+        bool (*m_is_corked)(CC_Mqtt5ClientHandle) = nullptr;
         CC_Mqtt5ErrorCode (*m_set_default_response_timeout)(CC_Mqtt5ClientHandle, unsigned) = nullptr;
         unsigned (*m_get_default_response_timeout)(CC_Mqtt5ClientHandle) = nullptr;
         CC_Mqtt5ErrorCode (*m_pub_topic_alias_alloc)(CC_Mqtt5ClientHandle, const char*, unsigned) = nullptr;
@@ -102,8 +113,12 @@ public:
         bool (*m_publish_was_initiated)(CC_Mqtt5PublishHandle) = nullptr;
         CC_Mqtt5ErrorCode (*m_publish_simple)(CC_Mqtt5ClientHandle, const CC_Mqtt5PublishBasicConfig*, CC_Mqtt5PublishCompleteCb, void*) = nullptr;
         CC_Mqtt5ErrorCode (*m_publish_full)(CC_Mqtt5ClientHandle, const CC_Mqtt5PublishBasicConfig*, const CC_Mqtt5PublishExtraConfig*, CC_Mqtt5PublishCompleteCb, void*) = nullptr;
+        CC_Mqtt5ErrorCode (*m_publish_batch)(CC_Mqtt5ClientHandle, const CC_Mqtt5PublishBasicConfig*, const CC_Mqtt5PublishExtraConfig*, unsigned, CC_Mqtt5PublishCompleteCb, void*, unsigned*) = nullptr;
         CC_Mqtt5ErrorCode (*m_publish_set_ordering)(CC_Mqtt5ClientHandle, CC_Mqtt5PublishOrdering) = nullptr;
         CC_Mqtt5PublishOrdering (*m_publish_get_ordering)(CC_Mqtt5ClientHandle) = nullptr;
+        CC_Mqtt5PublishTemplateHandle (*m_publish_template_alloc)(CC_Mqtt5ClientHandle, const CC_Mqtt5PublishBasicConfig*, const CC_Mqtt5PublishExtraConfig*, const CC_Mqtt5UserProp*, unsigned, CC_Mqtt5ErrorCode*) = nullptr;
+        CC_Mqtt5ErrorCode (*m_publish_template_free)(CC_Mqtt5ClientHandle, CC_Mqtt5PublishTemplateHandle) = nullptr;
+        CC_Mqtt5ErrorCode (*m_publish_template_send)(CC_Mqtt5ClientHandle, CC_Mqtt5PublishTemplateHandle, const unsigned char*, unsigned, const unsigned char*, unsigned, CC_Mqtt5PublishCompleteCb, void*) = nullptr;
         CC_Mqtt5ReauthHandle (*m_reauth_prepare)(CC_Mqtt5ClientHandle, CC_Mqtt5ErrorCode*) = nullptr;
         void (*m_reauth_init_config_auth)(CC_Mqtt5AuthConfig*) = nullptr;
         CC_Mqtt5ErrorCode (*m_reauth_set_response_timeout)(CC_Mqtt5ReauthHandle, unsigned) = nullptr;
@@ -116,8 +131,11 @@ public:
         void (*m_set_next_tick_program_callback)(CC_Mqtt5ClientHandle, CC_Mqtt5NextTickProgramCb, void*) = nullptr;
         void (*m_set_cancel_next_tick_wait_callback)(CC_Mqtt5ClientHandle, CC_Mqtt5CancelNextTickWaitCb, void*) = nullptr;
         void (*m_set_send_output_data_callback)(CC_Mqtt5ClientHandle, CC_Mqtt5SendOutputDataCb, void*) = nullptr;
+        void (*m_set_send_output_data_v_callback)(CC_Mqtt5ClientHandle, CC_Mqtt5SendOutputDataVCb, void*) = nullptr;
+        CC_Mqtt5ErrorCode (*m_set_output_buf_provider_callbacks)(CC_Mqtt5ClientHandle, CC_Mqtt5OutputBufReserveCb, CC_Mqtt5OutputBufCommitCb, void*) = nullptr;
         void (*m_set_broker_disconnect_report_callback)(CC_Mqtt5ClientHandle, CC_Mqtt5BrokerDisconnectReportCb, void*) = nullptr;
         void (*m_set_message_received_report_callback)(CC_Mqtt5ClientHandle, CC_Mqtt5MessageReceivedReportCb, void*) = nullptr;
+        CC_Mqtt5ErrorCode (*m_set_messages_received_report_callback)(CC_Mqtt5ClientHandle, CC_Mqtt5MessagesReceivedReportCb, void*) = nullptr;
         void (*m_set_error_log_callback)(CC_Mqtt5ClientHandle, CC_Mqtt5ErrorLogCb, void*) = nullptr;
     };
 
@@ -371,6 +389,11 @@ protected:
         return m_sentData;
     }
 
+    unsigned unitTestSentDataReportsCount() const
+    {
+        return m_sentDataReportsCount;
+    }
+
     const TickInfo* unitTestTickReq();
     bool unitTestCheckNoTicks();
     void unitTestTick(CC_Mqtt5Client* client, unsigned ms = 0, bool forceTick = false);
@@ -378,6 +401,8 @@ protected:
     CC_Mqtt5ErrorCode unitTestSendSubscribe(CC_Mqtt5SubscribeHandle& subscribe);
     CC_Mqtt5ErrorCode unitTestSendUnsubscribe(CC_Mqtt5UnsubscribeHandle& unsubscribe);
     CC_Mqtt5ErrorCode unitTestSendPublish(CC_Mqtt5PublishHandle& publish, bool clearHandle = true);
+    CC_Mqtt5ErrorCode unitTestSendPublishBatch(CC_Mqtt5ClientHandle handle, const CC_Mqtt5PublishBasicConfig* basicConfigs, const CC_Mqtt5PublishExtraConfig* extraConfigs, unsigned count, unsigned* sentCount);
+    CC_Mqtt5ErrorCode unitTestSendPublishTemplate(CC_Mqtt5ClientHandle handle, CC_Mqtt5PublishTemplateHandle tmpl, const UnitTestData& data, const UnitTestData& correlationData = UnitTestData());
     CC_Mqtt5ErrorCode unitTestSendReauth(CC_Mqtt5ReauthHandle& reauth);
     UniTestsMsgPtr unitTestGetSentMessage();
     bool unitTestHasSentMessage() const;
@@ -459,8 +484,20 @@ protected:
 
     // API wrappers
     UnitTestClientPtr apiAlloc();
+    unsigned apiProcessData(CC_Mqtt5Client* client, const unsigned char* buf, unsigned bufLen);
+    unsigned apiProcessDataV(CC_Mqtt5Client* client, const CC_Mqtt5DataSegment* segments, unsigned count);
     void apiNotifyNetworkDisconnected(CC_Mqtt5Client* client);
     bool apiIsNetworkDisconnected(CC_Mqtt5Client* client);
+    CC_Mqtt5ErrorCode apiSetIncrementalRecvEnabled(CC_Mqtt5Client* client, bool enabled);
+    bool apiGetIncrementalRecvEnabled(CC_Mqtt5Client* client);
+    CC_Mqtt5ErrorCode apiSetLazyPropsEnabled(CC_Mqtt5Client* client, bool enabled);
+    bool apiGetLazyPropsEnabled(CC_Mqtt5Client* client);
+    CC_Mqtt5ErrorCode apiFetchUserProps(CC_Mqtt5Client* client, CC_Mqtt5LazyUserPropsHandle lazyProps, const CC_Mqtt5UserProp** props, unsigned* count);
+    CC_Mqtt5ErrorCode apiSetAutoCorkEnabled(CC_Mqtt5Client* client, bool enabled);
+    bool apiGetAutoCorkEnabled(CC_Mqtt5Client* client);
+    void apiCork(CC_Mqtt5Client* client);
+    void apiUncork(CC_Mqtt5Client* client);
+    bool apiIsCorked(CC_Mqtt5Client* client);
     CC_Mqtt5ErrorCode apiSetDefaultResponseTimeout(CC_Mqtt5Client* client, unsigned ms);
     CC_Mqtt5ErrorCode apiPubTopicAliasAlloc(CC_Mqtt5Client* client, const char* topic, unsigned char qos0RegsCount);
     unsigned apiPubTopicAliasCount(CC_Mqtt5Client* client);
@@ -505,14 +542,20 @@ protected:
     bool apiPublishWasInitiated(CC_Mqtt5PublishHandle handle);
     CC_Mqtt5ErrorCode apiPublishSetOrdering(CC_Mqtt5ClientHandle handle, CC_Mqtt5PublishOrdering ordering);
     CC_Mqtt5PublishOrdering apiPublishGetOrdering(CC_Mqtt5ClientHandle handle);
+    CC_Mqtt5PublishTemplateHandle apiPublishTemplateAlloc(CC_Mqtt5ClientHandle handle, const CC_Mqtt5PublishBasicConfig* basic, const CC_Mqtt5PublishExtraConfig* extra, const CC_Mqtt5UserProp* userProps, unsigned userPropsCount, CC_Mqtt5ErrorCode* ec);
+    CC_Mqtt5ErrorCode apiPublishTemplateFree(CC_Mqtt5ClientHandle handle, CC_Mqtt5PublishTemplateHandle tmpl);
+    CC_Mqtt5ErrorCode apiPublishTemplateSend(CC_Mqtt5ClientHandle handle, CC_Mqtt5PublishTemplateHandle tmpl, const unsigned char* data, unsigned dataLen, const unsigned char* correlationData, unsigned correlationDataLen, CC_Mqtt5PublishCompleteCb cb, void* cbData);
     CC_Mqtt5ReauthHandle apiReauthPrepare(CC_Mqtt5Client* client, CC_Mqtt5ErrorCode* ec);
     void apiReauthInitConfigAuth(CC_Mqtt5AuthConfig* config);
     CC_Mqtt5ErrorCode apiReauthAddUserProp(CC_Mqtt5ReauthHandle handle, const CC_Mqtt5UserProp* prop);
     void apiSetNextTickProgramCb(CC_Mqtt5ClientHandle handle, CC_Mqtt5NextTickProgramCb cb, void* data);
     void apiSetCancelNextTickWaitCb(CC_Mqtt5ClientHandle handle, CC_Mqtt5CancelNextTickWaitCb cb, void* data);
     void apiSetSendOutputDataCb(CC_Mqtt5ClientHandle handle, CC_Mqtt5SendOutputDataCb cb, void* data);
+    void apiSetSendOutputDataVCb(CC_Mqtt5ClientHandle handle, CC_Mqtt5SendOutputDataVCb cb, void* data);
+    CC_Mqtt5ErrorCode apiSetOutputBufProviderCbs(CC_Mqtt5ClientHandle handle, CC_Mqtt5OutputBufReserveCb reserveCb, CC_Mqtt5OutputBufCommitCb commitCb, void* data);
     void apiSetBrokerDisconnectReportCb(CC_Mqtt5ClientHandle handle, CC_Mqtt5BrokerDisconnectReportCb cb, void* data);
     void apiSetMessageReceivedReportCb(CC_Mqtt5ClientHandle handle, CC_Mqtt5MessageReceivedReportCb cb, void* data);
+    CC_Mqtt5ErrorCode apiSetMessagesReceivedReportCb(CC_Mqtt5ClientHandle handle, CC_Mqtt5MessagesReceivedReportCb cb, void* data);
 
 private:
 
@@ -532,6 +575,7 @@ private:
     LibFuncs m_funcs;
     std::vector<TickInfo> m_tickReq;
     std::vector<std::uint8_t> m_sentData;
+    unsigned m_sentDataReportsCount = 0U;
     std::vector<std::uint8_t> m_receivedData;
     std::vector<UnitTestConnectResponseInfo> m_connectResp;
     std::vector<UnitTestSubscribeResponseInfo> m_subscribeResp;
@@ -9,8 +9,19 @@ const UnitTestDefaultBase::LibFuncs& UnitTestDefaultBase::getFuncs()
     funcs.m_free = &cc_mqtt5_client_free;
     funcs.m_tick = &cc_mqtt5_client_tick;
     funcs.m_process_data = &cc_mqtt5_client_process_data;
+    funcs.m_process_data_v = &cc_mqtt5_client_process_data_v;
     funcs.m_notify_network_disconnected = &cc_mqtt5_client_notify_network_disconnected;
     funcs.m_is_network_disconnected = &cc_mqtt5_client_is_network_disconnected;
+    funcs.m_set_incremental_recv_enabled = &cc_mqtt5_client_set_incremental_recv_enabled;
+    funcs.m_get_incremental_recv_enabled = &cc_mqtt5_client_get_incremental_recv_enabled;
+    funcs.m_set_lazy_props_enabled = &cc_mqtt5_client_set_lazy_props_enabled;
+    funcs.m_get_lazy_props_enabled = &cc_mqtt5_client_get_lazy_props_enabled;
+    funcs.m_fetch_user_props = &cc_mqtt5_client_fetch_user_props;
+    funcs.m_set_auto_cork_enabled = &cc_mqtt5_client_set_auto_cork_enabled;
+    funcs.m_get_auto_cork_enabled = &cc_mqtt5_client_get_auto_cork_enabled;
+    funcs.m_cork = &cc_mqtt5_client_cork;
+    funcs.m_uncork = &cc_mqtt5_client_uncork;
+    funcs.m_is_corked = &cc_mqtt5_client_is_corked;
     funcs.m_set_default_response_timeout = &cc_mqtt5_client_set_default_response_timeout;
     funcs.m_get_default_response_timeout = &cc_mqtt5_client_get_default_response_timeout;
     funcs.m_pub_topic_alias_alloc = &cc_mqtt5_client_pub_topic_alias_alloc;
@@ -88,8 +99,12 @@ const UnitTestDefaultBase::LibFuncs& UnitTestDefaultBase::getFuncs()
     funcs.m_publish_was_initiated = &cc_mqtt5_client_publish_was_initiated;
     funcs.m_publish_simple = &cc_mqtt5_client_publish_simple;
     funcs.m_publish_full = &cc_mqtt5_client_publish_full;
+    funcs.m_publish_batch = &cc_mqtt5_client_publish_batch;
     funcs.m_publish_set_ordering = &cc_mqtt5_client_publish_set_ordering;
     funcs.m_publish_get_ordering = &cc_mqtt5_client_publish_get_ordering;
+    funcs.m_publish_template_alloc = &cc_mqtt5_client_publish_template_alloc;
+    funcs.m_publish_template_free = &cc_mqtt5_client_publish_template_free;
+    funcs.m_publish_template_send = &cc_mqtt5_client_publish_template_send;
     funcs.m_reauth_prepare = &cc_mqtt5_client_reauth_prepare;
     funcs.m_reauth_init_config_auth = &cc_mqtt5_client_reauth_init_config_auth;
     funcs.m_reauth_set_response_timeout = &cc_mqtt5_client_reauth_set_response_timeout;
@@ -102,8 +117,11 @@ const UnitTestDefaultBase::LibFuncs& UnitTestDefaultBase::getFuncs()
     funcs.m_set_next_tick_program_callback = &cc_mqtt5_client_set_next_tick_program_callback;
     funcs.m_set_cancel_next_tick_wait_callback = &cc_mqtt5_client_set_cancel_next_tick_wait_callback;
     funcs.m_set_send_output_data_callback = &cc_mqtt5_client_set_send_output_data_callback;
+    funcs.m_set_send_output_data_v_callback = &cc_mqtt5_client_set_send_output_data_v_callback;
+    funcs.m_set_output_buf_provider_callbacks = &cc_mqtt5_client_set_output_buf_provider_callbacks;
     funcs.m_set_broker_disconnect_report_callback = &cc_mqtt5_client_set_broker_disconnect_report_callback;
     funcs.m_set_message_received_report_callback = &cc_mqtt5_client_set_message_received_report_callback;
+    funcs.m_set_messages_received_report_callback = &cc_mqtt5_client_set_messages_received_report_callback;
     funcs.m_set_error_log_callback = &cc_mqtt5_client_set_error_log_callback;
     return funcs;
 }
\ No newline at end of file
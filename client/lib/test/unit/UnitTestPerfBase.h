@@ -0,0 +1,16 @@
+#pragma once
+
+#include "UnitTestCommonBase.h"
+
+class UnitTestPerfBase : public UnitTestCommonBase
+{
+    using Base = UnitTestCommonBase;
+protected:
+
+    UnitTestPerfBase():
+        Base(getFuncs())
+    {
+    }
+
+    static const LibFuncs& getFuncs();
+};